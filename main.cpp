@@ -35,6 +35,7 @@
 #include <vector>           // STL vector container
 #include <iostream>         // For input and output operations
 #include <string>           // For string handling
+#include <algorithm>        // For std::min and std::max
 
 // Random number generation
 #include <random>           // For random number generation
@@ -53,7 +54,9 @@ int FRAME_DELAY;
 
 // To handle collisions between bubbles
 const int COLLISION_THRESHOLD = 10; // Set your desired threshold
-const Uint32 COLLISION_TIME_PERIOD = 5000; // Time period in milliseconds
+const Uint32 COLLISION_TIME_PERIOD = 5000; // Time period in milliseconds (at the target FPS)
+Uint32 collisionPeriodFrames;              // Time period in simulation steps
+Uint32 frameIndex = 0;                     // Number of simulation steps performed so far
 
 void initializeScreenDimensions() {
     SDL_DisplayMode DM;
@@ -80,7 +83,7 @@ struct Bubble
     SDL_Color targetColor;    // Target color for the bubble
     float colorChangeSpeed;   // Speed at which the color changes
     int collisionCount;       // Number of collisions detected
-    Uint32 lastCollisionTime; // Time of the last collision detection
+    Uint32 lastCollisionFrame; // Simulation step of the last collision detection
     bool isCollisionActive;     // Flag to activate/deactivate collision detection
 
     // Equality operator to compare two Bubble objects
@@ -188,6 +191,11 @@ void spawnBubble(std::uniform_int_distribution<> &spawn_dis_x,  std::uniform_int
     // Set the color change speed
     bubble.colorChangeSpeed = 0.01f;
 
+    // Start with collision detection active
+    bubble.collisionCount = 0;
+    bubble.lastCollisionFrame = frameIndex;
+    bubble.isCollisionActive = true;
+
     // Load the bubble image and create a texture
     SDL_Surface *surface = IMG_Load("../image/bubble.png");
     if (!surface)
@@ -244,17 +252,19 @@ void changeBubbleDirection()
 
 // Function to check and update collision states for all bubbles
 // This function manages the activation of collision detection based on the bubble's collision history
-// and the elapsed time since the last collision.
+// and the number of simulation steps since the last collision. Counting steps instead of wall-clock
+// time keeps the collision work independent of how fast the host runs the frames, as in the
+// parallel version.
 void checkCollisions() {
-    Uint32 currentTime = SDL_GetTicks(); // Get the current time in milliseconds
+    Uint32 currentFrame = frameIndex; // Current simulation step
 
     // Iterate over each bubble to check and update collision status
     for (auto &bubble : bubbles)
     {
         // Check if the bubble's collision count exceeds the threshold
         // and if the time since the last collision is less than the specified period
-        if (bubble.collisionCount > COLLISION_THRESHOLD && 
-            currentTime - bubble.lastCollisionTime < COLLISION_TIME_PERIOD)
+        if (bubble.collisionCount > COLLISION_THRESHOLD &&
+            currentFrame - bubble.lastCollisionFrame < collisionPeriodFrames)
         {
             // Deactivate collision detection for this bubble
             bubble.isCollisionActive = false;
@@ -266,11 +276,11 @@ void checkCollisions() {
         }
 
         // Check if the time period since the last collision has passed
-        if (currentTime - bubble.lastCollisionTime >= COLLISION_TIME_PERIOD)
+        if (currentFrame - bubble.lastCollisionFrame >= collisionPeriodFrames)
         {
-            // Reset the collision count and update the last collision time
+            // Reset the collision count and update the last collision step
             bubble.collisionCount = 0;
-            bubble.lastCollisionTime = currentTime;
+            bubble.lastCollisionFrame = currentFrame;
         }
     }
 }
@@ -319,6 +329,7 @@ void render()
 
     changeBubbleDirection(); // Update bubble directions
     checkCollisions(); // Check and deactivate collisions if necessary
+    frameIndex++;
     updateBubbleColors(); // Update bubble colors
 
     // Draw each bubble
@@ -371,6 +382,9 @@ int main(int argc, char *argv[]){
 
     FRAME_DELAY = 1000 / FPS;
 
+    // Convert the collision cooldown to simulation steps at the target FPS
+    collisionPeriodFrames = std::max<Uint32>(COLLISION_TIME_PERIOD * FPS / 1000, 1);
+
     // Initialize SDL
     if (SDL_Init(SDL_INIT_VIDEO) < 0)
     {
@@ -470,7 +484,7 @@ int main(int argc, char *argv[]){
         }
 
         Uint32 frameDelay = SDL_GetTicks() - frameStart;
-        if (frameDelay < FRAME_DELAY)
+        if (frameDelay < static_cast<Uint32>(FRAME_DELAY))
         {
             SDL_Delay(FRAME_DELAY - frameDelay);
         }
@@ -14,9 +14,38 @@
  * @usage:
  *  Compile the program with the required SDL2 and SDL_image libraries. 
  *  Run the program with the command:
- *      ./BubbleScreensaver <number of bubbles>
+ *      ./BubbleScreensaverParallel <number of bubbles> <target FPS> [options]
  *  Replace <number of bubbles> with the desired number of bubbles to display.
  *
+ * @options:
+ *  --cull          Enable viewport culling, occlusion culling and point LOD rendering
+ *  --zoom=<f>      Initial zoom factor of the viewport (requires --cull)
+ *  --multi-display Open one borderless window per display and span the world across all of them
+ *  --world=<W>x<H> Size of the simulated world, which may be larger than the displays
+ *  --regions=<R>   Split the world into R vertical regions, each stepped by its own thread
+ *  --headless      Run the simulation without a window and print its timings
+ *  --steps=<K>     Number of steps performed by a headless run (default 1000)
+ *  --processes=<P> Run a headless simulation split into P processes, each owning a horizontal strip
+ *  --publish=<name> Publish every completed frame into the POSIX shared-memory ring <name>
+ *  --broad-phase=<brute|grid|regions|bvh> Algorithm used to find colliding bubbles
+ *  --overlay       Show the per-phase timings overlay from the start
+ *  --wrap          Let bubbles wrap around the world's edges instead of bouncing off them
+ *  --no-color-animation  Keep every bubble at its initial color
+ *  --random-color-speed  Give every bubble its own color change speed
+ *  --pop-after=<C> Pop a bubble after C collisions
+ *  --max-age=<F>   Pop a bubble after F frames
+ *  --respawn       Replace every popped bubble with a new one
+ *  --seed=<S>      Seed of the random generator, for reproducible runs
+ *  --adaptive      Adjust quality and thread count to hold the target frame time
+ *  --verify[=<C>]  Compare C fuzzed parallel runs (default 20) against one-thread brute-force runs and exit
+ *
+ * @controls:
+ *  +/-             Add/remove BUBBLE_BATCH bubbles
+ *  1-9, 0          Use 1-9 threads, or every available core
+ *  C               Toggle collisions
+ *  B               Switch to the next broad-phase algorithm
+ *  O               Toggle the per-phase timings overlay
+ *
  * @libraries:
  *  - SDL2
  *  - SDL_image
@@ -35,6 +64,31 @@
 #include <vector>           // STL vector container
 #include <iostream>         // For input and output operations
 #include <string>           // For string handling
+#include <algorithm>        // For std::min and std::max
+#include <cmath>            // For std::abs
+#include <limits>           // For the initial bounds of the tree boxes
+#include <cstring>          // For strcmp, strncmp and strchr
+#include <cstdio>           // For snprintf
+#include <cstdlib>          // For getenv
+#include <cstdint>          // For fixed-size integers in messages between processes
+#include <utility>          // For std::index_sequence
+#include <tuple>            // For comparing bubbles field by field
+#include <fstream>          // For locating the bubble image
+#include <thread>           // For loading the bubble sprite in the background
+#include <atomic>           // For signalling that the sprite is loaded
+
+// Bubble sprite decoding and its preprocessed cache
+#include "sprite_cache.h"
+
+// POSIX headers for the distributed (multi-process) mode
+#if defined(__unix__)
+#include <sys/socket.h>     // For socketpair
+#include <sys/wait.h>       // For waitpid
+#include <unistd.h>         // For fork, read, write and close
+
+// Shared-memory ring used to publish the bubbles to other processes
+#include "bubble_shm.h"
+#endif
 
 // Random number generation
 #include <random>           // For random number generation
@@ -45,13 +99,40 @@
 // Define screen dimensions
 int SCREEN_WIDTH, SCREEN_HEIGHT;
 
+// Define world dimensions (the simulated canvas, which may span several displays)
+int WORLD_WIDTH, WORLD_HEIGHT;
+
+// Define the world dimensions used when running without a display
+const int HEADLESS_WORLD_WIDTH = 1920;
+const int HEADLESS_WORLD_HEIGHT = 1080;
+
 // Define frames per second (FPS) and frame delay
 int FPS;
 int FRAME_DELAY;
 
+// To handle culling and level of detail (LOD) when rendering dense scenes
+const int OCCLUSION_TILE_SIZE = 32; // Size in pixels of a coverage tile
+const int LOD_POINT_SIZE = 4;       // Sprites smaller than this (in pixels) are drawn as a single point
+
+// To handle the adaptive quality controller
+const int ADAPT_INTERVAL = 15;          // Frames averaged for every decision of the controller
+const int ADAPT_CONFIRM = 2;            // Consecutive decisions that must agree before a change
+const float ADAPT_OVER_BUDGET = 0.95f;  // Fraction of the frame budget above which quality is lowered
+const float ADAPT_HEADROOM = 0.6f;      // Fraction of the frame budget below which quality is raised
+const int MAX_COLLISION_INTERVAL = 4;   // Collisions are resolved at least every 4 steps
+const int MAX_COLOR_INTERVAL = 8;       // Colors are refreshed at least every 8 frames
+const int MAX_LOD_POINT_SIZE = 16;      // Largest sprites that may be drawn as points
+
+// Speed at which the bubbles' colors change (fraction of the full range per frame)
+const float COLOR_CHANGE_SPEED = 0.01f;
+
+// Number of bubbles added or removed at once with the keyboard
+const int BUBBLE_BATCH = 1000;
+
 // To handle collisions between bubbles
 const int COLLISION_THRESHOLD = 10; // Set your desired threshold
-const Uint32 COLLISION_TIME_PERIOD = 5000; // Time period in milliseconds
+const Uint32 COLLISION_TIME_PERIOD = 5000; // Time period in milliseconds (at the target FPS)
+Uint32 collisionPeriodFrames;              // Time period in simulation steps
 
 void initializeScreenDimensions() {
     SDL_DisplayMode DM;
@@ -66,20 +147,58 @@ void initializeScreenDimensions() {
 
 }
 
+// Bounds of every display the world is shown on, in desktop coordinates
+std::vector<SDL_Rect> displayBounds;
+
+// Function to initialize the world dimensions
+// In multi-display mode the world is the union of all display bounds; otherwise it is the
+// main display. A requested world size larger than that extends the canvas past the displays.
+void initializeWorldDimensions(bool multiDisplay, int requestedWidth, int requestedHeight) {
+    displayBounds.clear();
+
+    int numDisplays = multiDisplay ? SDL_GetNumVideoDisplays() : 1;
+    for (int i = 0; i < numDisplays; i++)
+    {
+        SDL_Rect bounds;
+        if (!multiDisplay || SDL_GetDisplayBounds(i, &bounds) != 0)
+        {
+            bounds = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+        }
+        displayBounds.push_back(bounds);
+    }
+
+    // Compute the union of all display bounds
+    int minX = displayBounds[0].x, minY = displayBounds[0].y;
+    int maxX = minX + displayBounds[0].w, maxY = minY + displayBounds[0].h;
+    for (auto &bounds : displayBounds)
+    {
+        minX = std::min(minX, bounds.x);
+        minY = std::min(minY, bounds.y);
+        maxX = std::max(maxX, bounds.x + bounds.w);
+        maxY = std::max(maxY, bounds.y + bounds.h);
+    }
+
+    WORLD_WIDTH = std::max(maxX - minX, requestedWidth);
+    WORLD_HEIGHT = std::max(maxY - minY, requestedHeight);
+}
+
 // Structure representing a bubble
 struct Bubble
 {
     glm::vec2 direction;      // Direction vector for the bubble's movement
     glm::vec2 position;       // Current position of the bubble
-    SDL_Texture *texture;     // Texture of the bubble image
     int limit_x;              // Width of the bubble texture
     int limit_y;              // Height of the bubble texture
-    SDL_Color color;          // Current color of the bubble
+    SDL_Color color;          // Current color of the bubble (evaluated at render time)
+    SDL_Color startColor;     // Color at the start of the current transition
     SDL_Color targetColor;    // Target color for the bubble
+    Uint32 colorStartFrame;   // Frame at which the current color transition started
     float colorChangeSpeed;   // Speed at which the color changes
     int collisionCount;       // Number of collisions detected
-    Uint32 lastCollisionTime; // Time of the last collision detection
+    Uint32 lastCollisionFrame; // Simulation step of the last collision detection
     bool isCollisionActive;     // Flag to activate/deactivate collision detection
+    int totalCollisions;      // Number of collisions since the bubble was spawned
+    Uint32 birthFrame;        // Frame at which the bubble was spawned
 
     // Equality operator to compare two Bubble objects
     // Reference --> https://stackoverflow.com/questions/16843323/c-object-equality
@@ -121,41 +240,324 @@ bool isCollision(const BoundingCircle &circle1, const BoundingCircle &circle2)
     return distance < (circle1.radius + circle2.radius);
 }
 
-// Function to handle collision between two bubbles
-// This function updates the direction of the bubbles if they collide,
-// and increments their collision counts if collision handling is active.
-void handleCollision(Bubble &bubble, Bubble &other, BoundingCircle &bubbleBound, BoundingCircle &otherBound) {
-    // Check if collision handling is active for both bubbles
+// Function to get the unit normal between the centers of two colliding circles
+// Circles sharing the same center have no normal; the zero vector is returned so that the
+// reflection leaves the direction unchanged instead of turning it into NaN.
+glm::vec2 getCollisionNormal(const BoundingCircle &from, const BoundingCircle &to)
+{
+    glm::vec2 offset = to.center - from.center;
+    float length = glm::length(offset);
+    return length > 0 ? offset / length : glm::vec2(0.0f);
+}
+
+// Function to handle a collision from the side of one bubble only
+// Only `bubble` is written, so every bubble can be updated by its own thread without locking.
+// The bubble's direction is reflected off the collision normal, and its collision counts grow by
+// two for each colliding neighbour and step: a pair is counted for both bubbles from each of its
+// two sides, and this function applies both counts for the bubble it writes.
+void handleCollisionFromOneSide(Bubble &bubble, const Bubble &other,
+                                const BoundingCircle &bubbleBound, const BoundingCircle &otherBound) {
     if (bubble.isCollisionActive && other.isCollisionActive) {
-        // Calculate the normal vector at the collision point
-        glm::vec2 collision_normal = glm::normalize(otherBound.center - bubbleBound.center);
-        // Calculate the dot product of the bubble's direction and collision normal
+        glm::vec2 collision_normal = getCollisionNormal(bubbleBound, otherBound);
         float dot_product = glm::dot(bubble.direction, collision_normal);
-        // Reflect the bubble's direction off the collision normal
         bubble.direction -= 2.0f * dot_product * collision_normal;
 
-        // Update the collision count for both bubbles
-        bubble.collisionCount++;
-        other.collisionCount++;
+        bubble.collisionCount += 2;
+        bubble.totalCollisions += 2;
+    }
+}
+
+// Contact between a bubble and a neighbour found by a broad phase
+struct Contact
+{
+    const Bubble *other;      // Colliding neighbour
+    BoundingCircle bound;     // Its bounding circle
+};
+
+// Function to resolve the contacts found for one bubble, then clear them
+// Successive reflections do not commute, so the contacts are applied in a canonical order (by the
+// neighbour's center) rather than in the order a broad phase found them. Every broad phase and
+// every order of the bubble array then produces the same directions.
+void resolveContacts(Bubble &bubble, const BoundingCircle &bubbleBound, std::vector<Contact> &contacts)
+{
+    if (contacts.size() > 1)
+    {
+        std::sort(contacts.begin(), contacts.end(), [](const Contact &a, const Contact &b) {
+            return a.bound.center.x < b.bound.center.x ||
+                   (a.bound.center.x == b.bound.center.x && a.bound.center.y < b.bound.center.y);
+        });
+    }
+    for (const auto &contact : contacts)
+    {
+        handleCollisionFromOneSide(bubble, *contact.other, bubbleBound, contact.bound);
     }
+    contacts.clear();
 }
 
+// Structure representing a window that shows part of the world
+struct View
+{
+    SDL_Window *window;       // Window the view is presented in
+    SDL_Renderer *renderer;   // Renderer of the window
+    SDL_Texture *sprites[SPRITE_MAX_LEVELS]; // Mip levels of the bubble sprite in this renderer
+    int spriteLevels;         // Number of levels in `sprites` (0 while the sprite is loading)
+    glm::vec2 origin;         // Top-left corner of the view in world coordinates
+    int width;                // Width of the view in pixels
+    int height;               // Height of the view in pixels
+    float zoom;               // Zoom factor of the view
+};
+
 // Global variables
-SDL_Renderer *renderer;            // SDL Renderer
 std::vector<Bubble> bubbles;       // Vector containing all bubbles
+std::vector<View> views;           // Windows the world is rendered to
+Uint32 frameIndex = 0;             // Number of simulation steps performed so far
+
+// Command-line options
+bool multiDisplayEnabled = false;  // Flag to span the world across every display
+int requestedWorldWidth = 0;       // Requested world width (0 = size of the displays)
+int requestedWorldHeight = 0;      // Requested world height (0 = size of the displays)
+float initialZoom = 1.0f;          // Initial zoom factor of the views in culling mode
+bool headlessEnabled = false;      // Flag to run the simulation without a window
+int headlessSteps = 1000;          // Number of steps performed by a headless run
+int numProcesses = 0;              // Number of processes of a distributed run (0 = single process)
+int spriteWidth = 0;               // Width of the bubble image
+int spriteHeight = 0;              // Height of the bubble image
+int ghostCount = 0;                // Number of read-only halo copies at the end of `bubbles`
+const char *publishName = NULL;    // Name of the shared-memory ring frames are published to
+
+// Broad-phase algorithms used to find the bubbles that may collide
+enum BroadPhase
+{
+    BROAD_PHASE_BRUTE_FORCE,   // Test every pair of bubbles
+    BROAD_PHASE_GRID,          // Test bubbles in neighbouring cells of a uniform grid
+    BROAD_PHASE_REGIONS,       // Test pairs inside each vertical region of the world
+    BROAD_PHASE_BVH,           // Test bubbles whose boxes overlap in a bounding-volume tree
+    BROAD_PHASE_COUNT
+};
+const char *BROAD_PHASE_NAMES[BROAD_PHASE_COUNT] = {"brute", "grid", "regions", "bvh"};
+
+// Simulation settings that can be changed at runtime
+BroadPhase broadPhase = BROAD_PHASE_BRUTE_FORCE; // Algorithm used to find colliding bubbles
+bool broadPhaseRequested = false;  // Flag set when the algorithm was chosen on the command line
+bool collisionsEnabled = true;     // Flag to activate collisions between bubbles
+bool overlayEnabled = false;       // Flag to show the per-phase timings overlay
+bool wrapWallsEnabled = false;     // Flag to wrap bubbles around the world's edges instead of bouncing
+bool colorAnimationEnabled = true; // Flag to animate the bubbles' colors
+bool randomColorSpeedEnabled = false; // Flag to give every bubble its own color change speed
+bool adaptiveEnabled = false;      // Flag to adjust quality and threads to hold the frame budget
+int verifyCases = 0;               // Number of fuzzed cases compared against the reference (0 = no check)
+int popAfterCollisions = 0;        // Collisions after which a bubble pops (0 = never)
+Uint32 maxBubbleAge = 0;           // Frames after which a bubble pops (0 = never)
+bool respawnEnabled = false;       // Flag to replace every popped bubble with a new one
+
+// Quality knobs adjusted by the adaptive controller
+struct QualitySettings
+{
+    int collisionInterval;    // Collisions are resolved every collisionInterval steps
+    int colorInterval;        // Colors are refreshed every colorInterval frames
+    int lodPointSize;         // Sprites smaller than this are drawn as points (culling mode)
+};
+QualitySettings quality = {1, 1, LOD_POINT_SIZE};
+bool colorRefreshFrame = true;     // Whether colors are refreshed in the current frame
+
+// Compile-time configuration of the simulation kernels
+// The kernels are templated on a policy so that settings which stay constant for a whole frame are
+// resolved at compile time: every combination is instantiated once and selectKernels() picks the
+// one matching the current settings, leaving no dead branches in the hot loops.
+template <bool Collisions, bool WrapWalls, bool ColorAnimation, bool UniformSpeed>
+struct KernelPolicy
+{
+    static constexpr bool collisions = Collisions;         // Bubbles collide with each other
+    static constexpr bool wrapWalls = WrapWalls;           // Bubbles wrap around instead of bouncing
+    static constexpr bool colorAnimation = ColorAnimation; // Colors move toward their targets
+    static constexpr bool uniformSpeed = UniformSpeed;     // Every bubble uses COLOR_CHANGE_SPEED
+};
+
+// Smoothed duration of every phase of a frame, in milliseconds
+struct PhaseTimes
+{
+    double movement;          // Moving the bubbles and resolving their collisions
+    double cooldown;          // Updating the collision cooldowns
+    double publish;           // Publishing the frame to shared memory
+    double draw;              // Issuing the draw calls of every view
+    double present;           // Presenting every view
+};
+PhaseTimes phaseTimes = {};
+
+// Scratch buffers used by the culling render mode
+bool cullingEnabled = false;       // Flag to activate culling and LOD rendering
+std::vector<SDL_Rect> screenRects; // Screen rectangle of each bubble for the current frame
+std::vector<char> isVisible;       // Whether each bubble is drawn in the current frame
+std::vector<Uint8> tileCoverage;   // Whether an opaque sprite footprint fully covers each tile
 
 // Random number generator
 std::random_device rd;          // Obtain a seed from hardware
-std::mt19937 gen(rd());         // Initialize the generator with the seed
+std::mt19937 gen(rd());         // Initialize the generator with the seed (replaced by --seed)
 std::uniform_int_distribution<> dis(-100, 100);     // Distribution for random direction values
 
 std::uniform_int_distribution<> spawn_dis_x(100, 1700);   // Distribution for random spawn value in x
 std::uniform_int_distribution<> spawn_dis_y(100, 700);   // Distribution for random spawn value in y
 std::uniform_int_distribution<> color_dis(0, 255);      // Distribution for random color values
 
-// Function to spawn a new bubble
-void spawnBubble() {
-    glm::vec2 spawn_point(spawn_dis_x(gen), spawn_dis_y(gen));
+// Bubble sprite assets
+std::string spritePath = "../image/bubble.png"; // Bubble image (resolved next to the binary at startup)
+std::string spriteCachePath = "bubble.sprite";  // Preprocessed sprite cache (written next to the binary)
+SpriteImage spriteImage = {};                   // Decoded sprite, filled by the loader thread
+std::thread spriteLoader;                       // Background thread decoding the sprite
+std::atomic<bool> spriteDecoded(false);         // Set by the loader thread once spriteImage is filled
+SDL_Rect spriteOpaqueRect = {0, 0, 0, 0};       // Fully opaque part of the sprite (empty if none)
+bool spriteUploaded = false;                    // Whether the views received their sprite textures
+
+// Function to locate the bubble image and its cache
+// The image is looked up next to the binary first (../image/ and image/), then relative to the
+// working directory, so the binary can be launched from any directory.
+void resolveSpritePaths()
+{
+    char *basePath = SDL_GetBasePath();
+    std::string base = basePath ? basePath : "";
+    SDL_free(basePath);
+
+    const std::string candidates[] = {base + "../image/bubble.png", base + "image/bubble.png", "../image/bubble.png"};
+    for (const auto &candidate : candidates)
+    {
+        if (std::ifstream(candidate).good())
+        {
+            spritePath = candidate;
+            break;
+        }
+    }
+    spriteCachePath = base + "bubble.sprite";
+}
+
+// Function to read the size of the bubble image from its header, without decoding it
+bool loadSpriteSize()
+{
+    std::vector<Uint8> source;
+    if (!readSpriteFile(spritePath, source) || !readPngSize(source, spriteWidth, spriteHeight))
+    {
+        SDL_Log("Unable to load image: %s", spritePath.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Function to decode the bubble sprite (runs on the loader thread)
+// The preprocessed cache is used when it was built from the same image; otherwise the image is
+// decoded and the cache is rewritten for the next start.
+void loadSpriteImage()
+{
+    std::vector<Uint8> source;
+    if (!readSpriteFile(spritePath, source))
+    {
+        spriteImage.levels = 0;
+    }
+    else if (!loadSpriteCache(spriteCachePath, source, spriteImage))
+    {
+        if (!decodeSprite(spritePath, spriteImage))
+        {
+            spriteImage.levels = 0;
+        }
+        else if (!writeSpriteCache(spriteCachePath, source, spriteImage))
+        {
+            SDL_Log("Unable to write sprite cache: %s", spriteCachePath.c_str());
+        }
+    }
+    findOpaqueFootprint(spriteImage, spriteOpaqueRect);
+    spriteDecoded.store(true, std::memory_order_release);
+}
+
+// Function to create the sprite textures of every view once the loader thread is done
+// Textures can only be created on the main thread; until then the bubbles are drawn as points.
+void uploadSprites()
+{
+    if (spriteUploaded || !spriteDecoded.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    spriteLoader.join();
+    spriteUploaded = true;
+
+    if (spriteImage.levels == 0)
+    {
+        SDL_Log("Unable to load image: %s", spritePath.c_str());
+        return;
+    }
+
+    // The pixels are premultiplied: the source color is added as is, without scaling it by alpha
+    SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+
+    std::vector<Uint8> straightPixels;   // Straight-alpha copy, built for the first renderer that needs it
+    for (auto &view : views)
+    {
+        for (int level = 0; level < spriteImage.levels; level++)
+        {
+            SDL_Texture *texture = SDL_CreateTexture(view.renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC,
+                                                     spriteImage.width[level], spriteImage.height[level]);
+            if (!texture)
+            {
+                SDL_Log("Unable to create texture: %s", SDL_GetError());
+                break;
+            }
+
+            // Renderers without custom blend modes fall back to plain alpha blending, which needs
+            // straight-alpha pixels (premultiplied ones would be darkened twice at the edges)
+            const Uint8 *pixels = spriteImage.pixels.data();
+            if (SDL_SetTextureBlendMode(texture, premultiplied) != 0)
+            {
+                SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+                if (straightPixels.empty())
+                {
+                    straightPixels = unpremultiplySprite(spriteImage);
+                }
+                pixels = straightPixels.data();
+            }
+            SDL_UpdateTexture(texture, NULL, pixels + spriteImage.offset[level], spriteImage.width[level] * 4);
+            view.sprites[view.spriteLevels++] = texture;
+        }
+    }
+
+    // The textures hold the pixels now
+    std::vector<Uint8>().swap(spriteImage.pixels);
+}
+
+// Function to pick the smallest sprite level that is at least `size` pixels wide
+// Returns NULL while the sprite is loading.
+SDL_Texture *getSpriteLevel(const View &view, int size)
+{
+    if (view.spriteLevels == 0)
+    {
+        return NULL;
+    }
+
+    int level = 0;
+    while (level + 1 < view.spriteLevels && spriteImage.width[level + 1] >= size)
+    {
+        level++;
+    }
+    return view.sprites[level];
+}
+
+// Function to draw a bubble as a point at the center of its rectangle while its sprite is loading
+void drawLoadingPoint(View &view, const SDL_Rect &rect, SDL_Color color)
+{
+    SDL_Rect point = {rect.x + rect.w / 2 - LOD_POINT_SIZE / 2, rect.y + rect.h / 2 - LOD_POINT_SIZE / 2,
+                      LOD_POINT_SIZE, LOD_POINT_SIZE};
+    SDL_SetRenderDrawColor(view.renderer, color.r, color.g, color.b, 255);
+    SDL_RenderFillRect(view.renderer, &point);
+}
+
+// Function to create a bubble with random position, direction and colors
+// Bubbles share the sprite of their view, so only the size of the image is stored. The shared
+// distributions are only read (calling one is a non-const operation), and only `generator` is
+// modified, so threads owning their own generator can create bubbles concurrently.
+Bubble makeBubble(std::mt19937 &generator) {
+    // Local distributions built from the parameters of the shared ones
+    std::uniform_int_distribution<> spawnX(spawn_dis_x.param()), spawnY(spawn_dis_y.param());
+    std::uniform_int_distribution<> directionDis(dis.param()), colorDis(color_dis.param());
+
+    glm::vec2 spawn_point(spawnX(generator), spawnY(generator));
     Bubble bubble;
     bubble.position = spawn_point;
 
@@ -163,8 +565,8 @@ void spawnBubble() {
     int x_random, y_random = 0;
 
     do {
-        x_random = dis(gen);
-        y_random = dis(gen);
+        x_random = directionDis(generator);
+        y_random = directionDis(generator);
     } while (x_random == 0 && y_random == 0); // Keep generating until it's not zero
 
     // Create a direction vector and normalize it
@@ -175,274 +577,2659 @@ void spawnBubble() {
     bubble.direction *= 1.0f;
 
     // Generate a random initial color for the bubble
-    bubble.color.r = color_dis(gen);
-    bubble.color.g = color_dis(gen);
-    bubble.color.b = color_dis(gen);
+    bubble.color.r = colorDis(generator);
+    bubble.color.g = colorDis(generator);
+    bubble.color.b = colorDis(generator);
     bubble.color.a = 255; // Full opacity
+    bubble.startColor = bubble.color;
+    bubble.colorStartFrame = frameIndex;
 
     // Generate a random target color for the bubble
-    bubble.targetColor.r = color_dis(gen);
-    bubble.targetColor.g = color_dis(gen);
-    bubble.targetColor.b = color_dis(gen);
+    bubble.targetColor.r = colorDis(generator);
+    bubble.targetColor.g = colorDis(generator);
+    bubble.targetColor.b = colorDis(generator);
     bubble.targetColor.a = 255; // Full opacity
 
     // Set the color change speed
-    bubble.colorChangeSpeed = 0.01f;
-
-    // Load the bubble image and create a texture
-    SDL_Surface *surface = IMG_Load("../image/bubble.png");
-    if (!surface)
+    bubble.colorChangeSpeed = COLOR_CHANGE_SPEED;
+    if (randomColorSpeedEnabled)
     {
-        SDL_Log("Unable to load image: %s", IMG_GetError());
-        return;
+        bubble.colorChangeSpeed *= 0.5f + colorDis(generator) / 170.0f;
     }
 
-    bubble.texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
+    // Start with collision detection active
+    bubble.collisionCount = 0;
+    bubble.lastCollisionFrame = frameIndex;
+    bubble.isCollisionActive = true;
+    bubble.totalCollisions = 0;
+    bubble.birthFrame = frameIndex;
 
-    if (!bubble.texture)
-    {
-        SDL_Log("Unable to create texture: %s", SDL_GetError());
-        return;
-    }
+    bubble.limit_x = spriteWidth;
+    bubble.limit_y = spriteHeight;
+    return bubble;
+}
 
-    // Set the texture's dimensions as the bubble's limits
-    SDL_QueryTexture(bubble.texture, NULL, NULL, &bubble.limit_x, &bubble.limit_y);
-    bubbles.push_back(bubble);
+// Function to spawn a new bubble
+void spawnBubble() {
+    bubbles.push_back(makeBubble(gen));
 }
 
-// Function to change the direction of bubbles when they hit the screen borders
-void changeBubbleDirection()
+// Function to reverse the direction of a bubble that reaches the world's edges
+// Wrapping worlds have no walls to bounce off.
+template <class Policy>
+void bounceOffWalls(Bubble &bubble)
 {
-    #pragma omp parallel for
-    for (int i = 0; i < bubbles.size(); i++)
+    if constexpr (!Policy::wrapWalls)
     {
-        auto &bubble = bubbles[i];
-        BoundingCircle bubbleBound = getBoundingCircle(bubble);
-
-        // Reverse direction if the bubble reaches the screen's edges
-        if (bubble.position.x <= 0 || bubble.position.x >= SCREEN_WIDTH - bubble.limit_x)
+        if (bubble.position.x <= 0 || bubble.position.x >= WORLD_WIDTH - bubble.limit_x)
         {
             bubble.direction.x *= -1;
         }
-        if (bubble.position.y <= 0 || bubble.position.y >= SCREEN_HEIGHT - bubble.limit_y)
+        if (bubble.position.y <= 0 || bubble.position.y >= WORLD_HEIGHT - bubble.limit_y)
         {
             bubble.direction.y *= -1;
         }
+    }
+}
 
-        // Check for collisions with other bubbles
-        for (int j = 0; j < bubbles.size(); j++) {
-            if (i != j) { 
-                BoundingCircle otherBound = getBoundingCircle(bubbles[j]);
-                if (isCollision(bubbleBound, otherBound)) {
-                    #pragma omp critical
-                    {
-                        handleCollision(bubble, bubbles[j], bubbleBound, otherBound);
-                    }
-                }
-            }
-        }
+// Function to move a bubble in its current direction
+// In a wrapping world, a bubble leaving through one edge comes back through the opposite one.
+template <class Policy>
+void moveBubble(Bubble &bubble)
+{
+    bubble.position += bubble.direction;
 
-        // Move the bubble in the current direction
-        bubble.position += bubble.direction;
+    if constexpr (Policy::wrapWalls)
+    {
+        float spanX = static_cast<float>(WORLD_WIDTH - bubble.limit_x);
+        float spanY = static_cast<float>(WORLD_HEIGHT - bubble.limit_y);
+        bubble.position.x += bubble.position.x < 0 ? spanX : (bubble.position.x > spanX ? -spanX : 0);
+        bubble.position.y += bubble.position.y < 0 ? spanY : (bubble.position.y > spanY ? -spanY : 0);
     }
 }
 
-// Function to check and update collision states for all bubbles
-// This function manages the activation of collision detection based on the bubble's collision history
-// and the elapsed time since the last collision.
-void checkCollisions() {
-    Uint32 currentTime = SDL_GetTicks(); // Get the current time in milliseconds
+// Function to change the direction of bubbles when they hit the screen borders
+// The step runs in two passes: every bubble first updates its own direction against the positions
+// of the previous step, then all bubbles move. No thread writes another thread's bubble, so the
+// result does not depend on the number of threads or on the loop schedule.
+template <class Policy>
+void changeBubbleDirection()
+{
+    // Halo copies owned by other processes are collided against but never moved
+    int count = bubbles.size();
+    int owned = count - ghostCount;
 
-    // Iterate over each bubble to check and update collision status
-    #pragma omp parallel for
-    for (int i = 0; i < bubbles.size(); i++)
+    #pragma omp parallel
     {
-        auto &bubble = bubbles[i];
-        // Check if the bubble's collision count exceeds the threshold
-        // and if the time since the last collision is less than the specified period
-        if (bubble.collisionCount > COLLISION_THRESHOLD && 
-            currentTime - bubble.lastCollisionTime < COLLISION_TIME_PERIOD)
-        {
-            // Deactivate collision detection for this bubble
-            bubble.isCollisionActive = false;
-        }
-        else
+        std::vector<Contact> contacts;   // Contacts of the current bubble (one buffer per thread)
+
+        #pragma omp for schedule(runtime)
+        for (int i = 0; i < owned; i++)
         {
-            // Activate collision detection for this bubble
-            bubble.isCollisionActive = true;
+            auto &bubble = bubbles[i];
+            BoundingCircle bubbleBound = getBoundingCircle(bubble);
+
+            // Reverse direction if the bubble reaches the world's edges
+            bounceOffWalls<Policy>(bubble);
+
+            // Check for collisions with other bubbles
+            for (int j = 0; Policy::collisions && j < count; j++) {
+                if (i != j) {
+                    BoundingCircle otherBound = getBoundingCircle(bubbles[j]);
+                    if (isCollision(bubbleBound, otherBound)) {
+                        contacts.push_back({&bubbles[j], otherBound});
+                    }
+                }
+            }
+            resolveContacts(bubble, bubbleBound, contacts);
         }
 
-        // Check if the time period since the last collision has passed
-        if (currentTime - bubble.lastCollisionTime >= COLLISION_TIME_PERIOD)
+        // Move the bubbles in their new directions once every direction is known
+        #pragma omp for schedule(runtime)
+        for (int i = 0; i < owned; i++)
         {
-            // Reset the collision count and update the last collision time
-            bubble.collisionCount = 0;
-            bubble.lastCollisionTime = currentTime;
+            moveBubble<Policy>(bubbles[i]);
         }
     }
 }
 
-// Function to gradually change the bubble's color toward the target color
-void updateBubbleColors()
+// Uniform grid used by the grid broad phase
+float gridCellSize = 1;            // Size of a cell (the largest bubble diameter)
+int gridColumns = 0;               // Number of columns of the grid
+int gridRows = 0;                  // Number of rows of the grid
+std::vector<int> gridCellStart;    // Index in gridBubbles of the first bubble of each cell
+std::vector<int> gridBubbles;      // Bubble indices sorted by cell
+std::vector<int> gridCellOf;       // Cell of each bubble
+
+// Function to get the grid cell containing a point, clamped to the grid
+int getGridCell(const glm::vec2 &point)
 {
-    #pragma omp parallel for
-    for (int i = 0; i < bubbles.size(); i++)
+    int column = std::min(std::max(static_cast<int>(point.x / gridCellSize), 0), gridColumns - 1);
+    int row = std::min(std::max(static_cast<int>(point.y / gridCellSize), 0), gridRows - 1);
+    return row * gridColumns + column;
+}
+
+// Function to sort the bubbles into the cells of the grid (counting sort)
+// Cells are as large as the largest bubble, so colliding bubbles are always in neighbouring cells.
+void buildGrid()
+{
+    int count = bubbles.size();
+    int largest = 1;
+
+    #pragma omp parallel for reduction(max : largest)
+    for (int i = 0; i < count; i++)
     {
-        auto &bubble = bubbles[i];
+        largest = std::max(largest, std::max(bubbles[i].limit_x, bubbles[i].limit_y));
+    }
 
-        // If the current color is close to the target color, set a new target color
-        if (abs(bubble.color.r - bubble.targetColor.r) < 1 &&
-            abs(bubble.color.g - bubble.targetColor.g) < 1 &&
-            abs(bubble.color.b - bubble.targetColor.b) < 1)
-        {
-            bubble.color.r = bubble.targetColor.r;
-            bubble.color.g = bubble.targetColor.g;
-            bubble.color.b = bubble.targetColor.b;
+    gridCellSize = static_cast<float>(largest);
+    gridColumns = static_cast<int>(WORLD_WIDTH / gridCellSize) + 1;
+    gridRows = static_cast<int>(WORLD_HEIGHT / gridCellSize) + 1;
+    gridCellOf.resize(count);
 
-            // Generate new target colors in a thread-safe way
-            #pragma omp critical
-            {
-                bubble.targetColor.r = color_dis(gen);
-                bubble.targetColor.g = color_dis(gen);
-                bubble.targetColor.b = color_dis(gen);
-            }
-        }
-        else
-        {
-            // Interpolate the bubble's color toward the target color
-            bubble.color.r = (bubble.color.r < bubble.targetColor.r)
-                ? std::min(bubble.color.r + bubble.colorChangeSpeed * 255, static_cast<float>(bubble.targetColor.r))
-                : std::max(bubble.color.r - bubble.colorChangeSpeed * 255, static_cast<float>(bubble.targetColor.r));
+    #pragma omp parallel for
+    for (int i = 0; i < count; i++)
+    {
+        gridCellOf[i] = getGridCell(getBoundingCircle(bubbles[i]).center);
+    }
 
-            bubble.color.g = (bubble.color.g < bubble.targetColor.g)
-                ? std::min(bubble.color.g + bubble.colorChangeSpeed * 255, static_cast<float>(bubble.targetColor.g))
-                : std::max(bubble.color.g - bubble.colorChangeSpeed * 255, static_cast<float>(bubble.targetColor.g));
+    gridCellStart.assign(gridColumns * gridRows + 1, 0);
+    for (int i = 0; i < count; i++)
+    {
+        gridCellStart[gridCellOf[i] + 1]++;
+    }
+    for (int cell = 0; cell < gridColumns * gridRows; cell++)
+    {
+        gridCellStart[cell + 1] += gridCellStart[cell];
+    }
 
-            bubble.color.b = (bubble.color.b < bubble.targetColor.b)
-                ? std::min(bubble.color.b + bubble.colorChangeSpeed * 255, static_cast<float>(bubble.targetColor.b))
-                : std::max(bubble.color.b - bubble.colorChangeSpeed * 255, static_cast<float>(bubble.targetColor.b));
-        }
+    std::vector<int> next(gridCellStart.begin(), gridCellStart.end() - 1);
+    gridBubbles.resize(count);
+    for (int i = 0; i < count; i++)
+    {
+        gridBubbles[next[gridCellOf[i]]++] = i;
     }
 }
 
-// Function to render bubbles on the screen
-void render()
+// Function to move the bubbles, only testing collisions against the neighbouring grid cells
+template <class Policy>
+void changeBubbleDirectionGrid()
 {
-    // Clear the screen with a black background
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
+    // Without collisions there are no pairs to look up
+    if constexpr (Policy::collisions)
+    {
+        buildGrid();
+    }
 
-    changeBubbleDirection(); // Update bubble directions
-    checkCollisions(); // Check and deactivate collisions if necessary
-    updateBubbleColors(); // Update bubble colors
+    // Halo copies owned by other processes are collided against but never moved
+    int owned = bubbles.size() - ghostCount;
 
-    // Draw each bubble
-    for (auto &bubble : bubbles)
+    // Directions are updated first and positions afterwards, as in changeBubbleDirection()
+    #pragma omp parallel
     {
-        SDL_Rect destRect;
-        destRect.x = static_cast<int>(bubble.position.x);
-        destRect.y = static_cast<int>(bubble.position.y);
-        destRect.w = bubble.limit_x;
-        destRect.h = bubble.limit_y;
+        std::vector<Contact> contacts;
 
-        // Apply color modulation to the bubble texture
-        SDL_SetTextureColorMod(bubble.texture, bubble.color.r, bubble.color.g, bubble.color.b);
+        #pragma omp for schedule(runtime)
+        for (int i = 0; i < owned; i++)
+        {
+            auto &bubble = bubbles[i];
+            BoundingCircle bubbleBound = getBoundingCircle(bubble);
 
-        SDL_RenderCopy(renderer, bubble.texture, NULL, &destRect);
-    }
+            // Reverse direction if the bubble reaches the world's edges
+            bounceOffWalls<Policy>(bubble);
+
+            // Check for collisions with the bubbles of the 3x3 neighbouring cells
+            int column = Policy::collisions ? gridCellOf[i] % gridColumns : 0;
+            int row = Policy::collisions ? gridCellOf[i] / gridColumns : 0;
+            for (int y = std::max(row - 1, 0); Policy::collisions && y <= std::min(row + 1, gridRows - 1); y++)
+            {
+                for (int x = std::max(column - 1, 0); x <= std::min(column + 1, gridColumns - 1); x++)
+                {
+                    int cell = y * gridColumns + x;
+                    for (int k = gridCellStart[cell]; k < gridCellStart[cell + 1]; k++)
+                    {
+                        int j = gridBubbles[k];
+                        if (i != j) {
+                            BoundingCircle otherBound = getBoundingCircle(bubbles[j]);
+                            if (isCollision(bubbleBound, otherBound)) {
+                                contacts.push_back({&bubbles[j], otherBound});
+                            }
+                        }
+                    }
+                }
+            }
+            resolveContacts(bubble, bubbleBound, contacts);
+        }
 
-    // Present the rendered frame on the screen
-    SDL_RenderPresent(renderer);
+        #pragma omp for schedule(runtime)
+        for (int i = 0; i < owned; i++)
+        {
+            moveBubble<Policy>(bubbles[i]);
+        }
+    }
 }
 
-// Main function
-int main(int argc, char *argv[]){
-    int num_bubbles;    // Number of bubbles
+// Spatial regions used to split the world between threads
+int numRegions = 0;                          // Number of vertical regions (0 = one per thread)
+std::vector<int> regionStart;                // Index of the first bubble of each region in `bubbles`
+std::vector<int> regionStayCount;            // Number of bubbles that stayed in each region this frame
+std::vector<std::vector<Bubble>> regionOutbox; // Bubbles that left each region this frame
+std::vector<std::vector<Bubble>> regionInbox;  // Bubbles that entered each region this frame
+std::vector<std::vector<int>> regionHalo;    // Bubbles of other regions close enough to collide with each region
+std::vector<Bubble> regionScratch;           // Scratch buffer used to rebuild `bubbles`
+
+// Function to get the region a bubble belongs to, based on the center of its bounding circle
+int getRegion(const Bubble &bubble)
+{
+    float centerX = getBoundingCircle(bubble).center.x;
+    int region = static_cast<int>(centerX * numRegions / WORLD_WIDTH);
+    return std::min(std::max(region, 0), numRegions - 1);
+}
 
-    std::cout << "Initializing SDL" << std::endl;
+// Function to sort every bubble into its region
+// This is only needed once after spawning; afterwards bubbles are moved by exchangeMigrants().
+void assignRegions()
+{
+    regionStart.assign(numRegions + 1, 0);
+    regionStayCount.assign(numRegions, 0);
+    regionOutbox.assign(numRegions, std::vector<Bubble>());
+    regionInbox.assign(numRegions, std::vector<Bubble>());
+    regionHalo.assign(numRegions, std::vector<int>());
 
-    // Ensure the correct number of arguments is provided
-    if (argc != 3)
+    for (auto &bubble : bubbles)
     {
-        std::cout << "Usage: " << argv[0] << " <Number of Bubbles> <Target FPS>" << std::endl;
-        return 1;
+        regionStart[getRegion(bubble) + 1]++;
     }
-
-    // Convert command-line arguments to integers
-    char *endptr1, *endptr2;
-    num_bubbles = strtol(argv[1], &endptr1, 10);    // Number of bubbles to display
-    FPS = strtol(argv[2], &endptr2, 10); // Number of desired FPS
-
-    // Validate the input
-    if (num_bubbles <= 0 || *endptr1 != '\0') {
-        printf("Error: Please enter a positive integer for the number of bubbles.\n");
-        return 1;
+    for (int r = 0; r < numRegions; r++)
+    {
+        regionStart[r + 1] += regionStart[r];
     }
 
-    // Validate the input
-    if (FPS <= 0 || *endptr2 != '\0') {
-        printf("Error: Please enter a positive integer for the number of FPS.\n");
-        return 1;
+    std::vector<int> next(regionStart.begin(), regionStart.end() - 1);
+    regionScratch.resize(bubbles.size());
+    for (auto &bubble : bubbles)
+    {
+        regionScratch[next[getRegion(bubble)]++] = bubble;
     }
+    bubbles.swap(regionScratch);
+}
 
-    // Initialize SDL
-    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+// Function to append the bubbles waiting in every region's inbox to that region
+// The first regionStayCount[r] bubbles of each region are kept; they are copied as a block, in
+// parallel, to the start of their region's new range, followed by the region's inbox.
+void mergeRegionInboxes()
+{
+    // Compute the new range of each region
+    std::vector<int> newStart(numRegions + 1, 0);
+    for (int r = 0; r < numRegions; r++)
     {
-        SDL_Log("Unable to initialize SDL: %s", SDL_GetError());
-        return 1;
+        newStart[r + 1] = newStart[r] + regionStayCount[r] + regionInbox[r].size();
     }
 
-    // Initialize SDL_image
-    if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG))
+    regionScratch.resize(newStart[numRegions]);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int r = 0; r < numRegions; r++)
     {
-        SDL_Log("Failed to initialize SDL_image: %s", IMG_GetError());
-        SDL_Quit();
-        return 1;
+        std::copy(bubbles.begin() + regionStart[r], bubbles.begin() + regionStart[r] + regionStayCount[r],
+                  regionScratch.begin() + newStart[r]);
+        std::copy(regionInbox[r].begin(), regionInbox[r].end(),
+                  regionScratch.begin() + newStart[r] + regionStayCount[r]);
+        regionInbox[r].clear();
     }
 
-    // Initialize screen dimensions
-    initializeScreenDimensions();
-    
-    std::uniform_int_distribution<> spawn_dis_x(100, SCREEN_WIDTH - 200);   // Distribution for random spawn value in x
-    std::uniform_int_distribution<> spawn_dis_y(100, SCREEN_HEIGHT - 200);   // Distribution for random spawn value in y
-
-    // Create a window
-    SDL_Window *window = SDL_CreateWindow("FPS: 0",
-                                          SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-                                          SCREEN_WIDTH, SCREEN_HEIGHT,
-                                          SDL_WINDOW_SHOWN);
+    bubbles.swap(regionScratch);
+    regionStart.swap(newStart);
+}
 
-    if (!window)
+// Function to exchange the bubbles that crossed a region boundary
+// Only the migrating bubbles are routed between regions; the bubbles that stayed are kept in place
+// by mergeRegionInboxes().
+void exchangeMigrants()
+{
+    size_t migrants = 0;
+    for (int r = 0; r < numRegions; r++)
     {
-        SDL_Log("Unable to create window: %s", SDL_GetError());
-        SDL_Quit();
-        return 1;
+        for (auto &bubble : regionOutbox[r])
+        {
+            regionInbox[getRegion(bubble)].push_back(bubble);
+        }
+        migrants += regionOutbox[r].size();
+        regionOutbox[r].clear();
     }
 
-    // Create a renderer
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    if (migrants > 0)
+    {
+        mergeRegionInboxes();
+    }
+}
 
-    if (!renderer)
+// Function to collect the halo of a region
+// The halo holds the bubbles of the other regions whose center lies within `haloDistance` of the
+// region's boundaries, like the halo exchanged between the strips of a distributed run. They are
+// referenced by index and only read while the region's own bubbles update their directions.
+void buildRegionHalo(int r, float haloDistance)
+{
+    float left = static_cast<float>(WORLD_WIDTH) * r / numRegions - haloDistance;
+    float right = static_cast<float>(WORLD_WIDTH) * (r + 1) / numRegions + haloDistance;
+    int first = std::max(static_cast<int>(left * numRegions / WORLD_WIDTH), 0);
+    int last = std::min(static_cast<int>(right * numRegions / WORLD_WIDTH), numRegions - 1);
+
+    auto &halo = regionHalo[r];
+    halo.clear();
+    for (int k = first; k <= last; k++)
     {
-        SDL_Log("Unable to create renderer: %s", SDL_GetError());
-        SDL_DestroyWindow(window);
-        SDL_Quit();
-        return 1;
+        for (int j = regionStart[k]; k != r && j < regionStart[k + 1]; j++)
+        {
+            float centerX = getBoundingCircle(bubbles[j]).center.x;
+            if (centerX > left && centerX < right)
+            {
+                halo.push_back(j);
+            }
+        }
     }
+}
 
-    // Spawn the bubbles
-    for (int i = 0; i < num_bubbles; i++)
+// Function to move the bubbles and handle their collisions region by region
+// Each region is owned by a single thread. Its bubbles are collided against the bubbles of the
+// same region and against its halo, so pairs straddling a boundary are not missed. As in
+// changeBubbleDirection(), every direction is updated before any bubble moves, and a thread only
+// writes the bubbles of its own region. Bubbles whose center crossed into another region are
+// handed over by exchangeMigrants() at the end of the step.
+template <class Policy>
+void changeBubbleDirectionRegions()
+{
+    // Colliding bubbles are never further apart than the largest bubble
+    int largest = 1;
+    if constexpr (Policy::collisions)
     {
-        spawnBubble();
+        int count = bubbles.size();
+        #pragma omp parallel for reduction(max : largest)
+        for (int i = 0; i < count; i++)
+        {
+            largest = std::max(largest, std::max(bubbles[i].limit_x, bubbles[i].limit_y));
+        }
     }
 
+    #pragma omp parallel
+    {
+        std::vector<Contact> contacts;
+
+        #pragma omp for schedule(dynamic, 1)
+        for (int r = 0; r < numRegions; r++)
+        {
+            int begin = regionStart[r], end = regionStart[r + 1];
+            if (Policy::collisions)
+            {
+                buildRegionHalo(r, static_cast<float>(largest));
+            }
+
+            for (int i = begin; i < end; i++)
+            {
+                auto &bubble = bubbles[i];
+                BoundingCircle bubbleBound = getBoundingCircle(bubble);
+
+                // Reverse direction if the bubble reaches the world's edges
+                bounceOffWalls<Policy>(bubble);
+
+                // Check for collisions with the other bubbles of the region, then with its halo
+                for (int j = begin; Policy::collisions && j < end; j++) {
+                    if (i != j) {
+                        BoundingCircle otherBound = getBoundingCircle(bubbles[j]);
+                        if (isCollision(bubbleBound, otherBound)) {
+                            contacts.push_back({&bubbles[j], otherBound});
+                        }
+                    }
+                }
+                for (size_t k = 0; Policy::collisions && k < regionHalo[r].size(); k++) {
+                    int j = regionHalo[r][k];
+                    BoundingCircle otherBound = getBoundingCircle(bubbles[j]);
+                    if (isCollision(bubbleBound, otherBound)) {
+                        contacts.push_back({&bubbles[j], otherBound});
+                    }
+                }
+                resolveContacts(bubble, bubbleBound, contacts);
+            }
+        }
+
+        // Move the bubbles once every direction is known
+        #pragma omp for schedule(dynamic, 1)
+        for (int r = 0; r < numRegions; r++)
+        {
+            int begin = regionStart[r], end = regionStart[r + 1];
+            for (int i = begin; i < end; i++)
+            {
+                moveBubble<Policy>(bubbles[i]);
+            }
+
+            // Keep the bubbles that stayed at the front of the region and send the others away
+            auto split = std::stable_partition(bubbles.begin() + begin, bubbles.begin() + end,
+                                               [r](const Bubble &bubble) { return getRegion(bubble) == r; });
+            regionStayCount[r] = split - (bubbles.begin() + begin);
+            regionOutbox[r].assign(split, bubbles.begin() + end);
+        }
+    }
+
+    exchangeMigrants();
+}
+
+// Bounding-volume tree used by the BVH broad phase
+const int BVH_LEAF_SIZE = 8;           // Largest number of bubbles in a leaf
+const int BVH_TASK_SIZE = 2048;        // Smallest range split into parallel tasks while building
+const int BVH_STACK_SIZE = 64;         // Depth of the traversal stack (the tree is balanced)
+const float BVH_REBUILD_RATIO = 1.5f;  // Growth of the tree cost (vs. the last build) that triggers a rebuild
+
+// Node of the tree: an axis-aligned box around the bounding circles below it
+struct BvhNode
+{
+    glm::vec2 min;            // Lower corner of the box
+    glm::vec2 max;            // Upper corner of the box
+    int left;                 // First child (-1 for a leaf)
+    int right;                // Second child
+    int first;                // Index in bvhBubbles of the first bubble of a leaf
+    int count;                // Number of bubbles of a leaf (0 for an inner node)
+};
+
+std::vector<BvhNode> bvhNodes;     // Nodes of the tree; children always come after their parent
+int bvhNodeCount = 0;              // Number of nodes in use
+std::vector<int> bvhBubbles;       // Bubble indices, grouped by leaf
+std::vector<glm::vec2> bvhCenters; // Centers of the bounding circles when the tree was built
+bool bvhValid = false;             // Whether the tree matches the current bubbles
+size_t bvhBubbleCount = 0;         // Number of bubbles the tree was built for
+double bvhBuildCost = 0;           // Cost of the tree right after its last build
+int bvhRebuilds = 0;               // Number of rebuilds, for the statistics
+
+// Function to split a range of bubbles into a subtree rooted at `node`
+// The range is split at the median of the longer axis of its centers, so the tree stays balanced
+// however the bubbles are clustered. Large ranges build their two halves as parallel tasks.
+void buildBvhNode(int node, int begin, int end)
+{
+    BvhNode &current = bvhNodes[node];
+    if (end - begin <= BVH_LEAF_SIZE)
+    {
+        current.left = current.right = -1;
+        current.first = begin;
+        current.count = end - begin;
+        return;
+    }
+
+    glm::vec2 low = bvhCenters[bvhBubbles[begin]], high = low;
+    for (int k = begin + 1; k < end; k++)
+    {
+        low = glm::min(low, bvhCenters[bvhBubbles[k]]);
+        high = glm::max(high, bvhCenters[bvhBubbles[k]]);
+    }
+    int axis = high.x - low.x >= high.y - low.y ? 0 : 1;
+
+    // Ties are broken by index, so the split does not depend on the order the range arrived in
+    int middle = begin + (end - begin) / 2;
+    std::nth_element(bvhBubbles.begin() + begin, bvhBubbles.begin() + middle, bvhBubbles.begin() + end,
+                     [axis](int a, int b) {
+                         float ca = bvhCenters[a][axis], cb = bvhCenters[b][axis];
+                         return ca < cb || (ca == cb && a < b);
+                     });
+
+    int children;
+    #pragma omp atomic capture
+    {
+        children = bvhNodeCount;
+        bvhNodeCount += 2;
+    }
+    current.left = children;
+    current.right = children + 1;
+    current.count = 0;
+
+    if (end - begin > BVH_TASK_SIZE)
+    {
+        #pragma omp task
+        buildBvhNode(children, begin, middle);
+        buildBvhNode(children + 1, middle, end);
+        #pragma omp taskwait
+    }
+    else
+    {
+        buildBvhNode(children, begin, middle);
+        buildBvhNode(children + 1, middle, end);
+    }
+}
+
+// Function to recompute the boxes of the tree from the current bubble positions
+// Leaves are refitted in parallel, then inner nodes in reverse order (children come after their
+// parent). Returns the cost of the tree: the summed perimeter of its inner boxes.
+double refitBvh()
+{
+    #pragma omp parallel for
+    for (int node = 0; node < bvhNodeCount; node++)
+    {
+        BvhNode &leaf = bvhNodes[node];
+        if (leaf.left >= 0)
+        {
+            continue;
+        }
+
+        leaf.min = glm::vec2(std::numeric_limits<float>::max());
+        leaf.max = glm::vec2(std::numeric_limits<float>::lowest());
+        for (int k = leaf.first; k < leaf.first + leaf.count; k++)
+        {
+            BoundingCircle circle = getBoundingCircle(bubbles[bvhBubbles[k]]);
+            leaf.min = glm::min(leaf.min, circle.center - circle.radius);
+            leaf.max = glm::max(leaf.max, circle.center + circle.radius);
+        }
+    }
+
+    double cost = 0;
+    for (int node = bvhNodeCount - 1; node >= 0; node--)
+    {
+        BvhNode &inner = bvhNodes[node];
+        if (inner.left < 0)
+        {
+            continue;
+        }
+        inner.min = glm::min(bvhNodes[inner.left].min, bvhNodes[inner.right].min);
+        inner.max = glm::max(bvhNodes[inner.left].max, bvhNodes[inner.right].max);
+        cost += (inner.max.x - inner.min.x) + (inner.max.y - inner.min.y);
+    }
+    return cost;
+}
+
+// Function to rebuild the tree from scratch over every bubble (halo copies included)
+void buildBvh()
+{
+    int count = bubbles.size();
+    bvhBubbles.resize(count);
+    bvhCenters.resize(count);
+    bvhNodes.resize(std::max(2 * count, 1));
+
+    #pragma omp parallel for
+    for (int i = 0; i < count; i++)
+    {
+        bvhBubbles[i] = i;
+        bvhCenters[i] = getBoundingCircle(bubbles[i]).center;
+    }
+
+    bvhNodeCount = 1;
+    #pragma omp parallel
+    #pragma omp single
+    buildBvhNode(0, 0, count);
+
+    bvhBuildCost = refitBvh();
+    bvhBubbleCount = count;
+    bvhValid = true;
+    bvhRebuilds++;
+}
+
+// Function to bring the tree up to date before the collision queries
+// Moving bubbles only need a refit; the tree is rebuilt when the bubbles changed or when the
+// refitted boxes overlap so much that the cost grew past BVH_REBUILD_RATIO times its built cost.
+void updateBvh()
+{
+    // Bubbles added or removed at runtime change the count
+    if (!bvhValid || bvhBubbleCount != bubbles.size())
+    {
+        buildBvh();
+        return;
+    }
+    if (refitBvh() > BVH_REBUILD_RATIO * bvhBuildCost)
+    {
+        buildBvh();
+    }
+}
+
+// Function to move the bubbles, only testing collisions against the leaves of the tree their circle overlaps
+// Directions are updated first and positions afterwards, as in changeBubbleDirection(). The tree is
+// traversed in the same order for every bubble, so the result does not depend on the threads.
+template <class Policy>
+void changeBubbleDirectionBvh()
+{
+    // Without collisions there are no pairs to look up
+    if constexpr (Policy::collisions)
+    {
+        updateBvh();
+    }
+
+    // Halo copies owned by other processes are collided against but never moved
+    int owned = bubbles.size() - ghostCount;
+
+    #pragma omp parallel
+    {
+        std::vector<Contact> contacts;
+
+        #pragma omp for schedule(runtime)
+        for (int i = 0; i < owned; i++)
+        {
+            auto &bubble = bubbles[i];
+            BoundingCircle bubbleBound = getBoundingCircle(bubble);
+
+            // Reverse direction if the bubble reaches the world's edges
+            bounceOffWalls<Policy>(bubble);
+
+            // Check for collisions with the bubbles of every leaf whose box overlaps the circle's box
+            glm::vec2 low = bubbleBound.center - bubbleBound.radius;
+            glm::vec2 high = bubbleBound.center + bubbleBound.radius;
+            int stack[BVH_STACK_SIZE];
+            int depth = 0;
+            if (Policy::collisions && bvhNodeCount > 0)
+            {
+                stack[depth++] = 0;
+            }
+            while (depth > 0)
+            {
+                const BvhNode &node = bvhNodes[stack[--depth]];
+                if (node.min.x > high.x || node.max.x < low.x || node.min.y > high.y || node.max.y < low.y)
+                {
+                    continue;
+                }
+                if (node.left >= 0)
+                {
+                    stack[depth++] = node.right;
+                    stack[depth++] = node.left;
+                    continue;
+                }
+
+                for (int k = node.first; k < node.first + node.count; k++)
+                {
+                    int j = bvhBubbles[k];
+                    if (i != j) {
+                        BoundingCircle otherBound = getBoundingCircle(bubbles[j]);
+                        if (isCollision(bubbleBound, otherBound)) {
+                            contacts.push_back({&bubbles[j], otherBound});
+                        }
+                    }
+                }
+            }
+            resolveContacts(bubble, bubbleBound, contacts);
+        }
+
+        #pragma omp for schedule(runtime)
+        for (int i = 0; i < owned; i++)
+        {
+            moveBubble<Policy>(bubbles[i]);
+        }
+    }
+}
+
+// Function to check and update collision states for all bubbles
+// This function manages the activation of collision detection based on the bubble's collision history
+// and the number of frames since the last collision. The cooldown is driven by the simulation clock
+// (frameIndex) rather than the wall clock, so the same inputs produce the same work on any machine
+// and at any frame rate. The update is branch-free so that it vectorizes.
+template <class Policy>
+void checkCollisions() {
+    // Without collisions there is no cooldown to track
+    if constexpr (!Policy::collisions)
+    {
+        return;
+    }
+
+    Uint32 currentFrame = frameIndex;          // Current simulation step
+    Uint32 period = collisionPeriodFrames;     // Cooldown period in simulation steps
+    int count = bubbles.size();
+
+    // Iterate over each bubble to check and update collision status
+    #pragma omp parallel for simd
+    for (int i = 0; i < count; i++)
+    {
+        auto &bubble = bubbles[i];
+        bool expired = currentFrame - bubble.lastCollisionFrame >= period;
+
+        // Deactivate collision detection while the bubble's collision count exceeds the threshold
+        // and the period since the last collision has not passed yet
+        bubble.isCollisionActive = !(bubble.collisionCount > COLLISION_THRESHOLD && !expired);
+
+        // Reset the collision count and update the last collision frame once the period has passed
+        bubble.collisionCount = expired ? 0 : bubble.collisionCount;
+        bubble.lastCollisionFrame = expired ? currentFrame : bubble.lastCollisionFrame;
+    }
+}
+
+// Function to interpolate one color channel from its start value toward its target value
+// The channel moves by `step` units and stops once it reaches the target.
+Uint8 interpolateChannel(Uint8 start, Uint8 target, float step)
+{
+    float delta = static_cast<float>(target) - static_cast<float>(start);
+    if (std::abs(delta) <= step)
+    {
+        return target;
+    }
+    return static_cast<Uint8>(start + (delta > 0 ? step : -step));
+}
+
+// Function to get the number of frames a bubble needs to reach its target color
+// The slowest channel (largest difference) determines the duration of the transition.
+template <class Policy>
+float getColorTransitionFrames(const Bubble &bubble)
+{
+    int maxDelta = std::max({std::abs(bubble.targetColor.r - bubble.startColor.r),
+                             std::abs(bubble.targetColor.g - bubble.startColor.g),
+                             std::abs(bubble.targetColor.b - bubble.startColor.b)});
+    if constexpr (Policy::uniformSpeed)
+    {
+        return maxDelta * (1.0f / (COLOR_CHANGE_SPEED * 255));
+    }
+    return maxDelta / (bubble.colorChangeSpeed * 255);
+}
+
+// Function to evaluate the bubble's color at a given frame
+// Instead of stepping every bubble toward its target each frame, the color is computed in
+// closed form from (startColor, targetColor, colorStartFrame, colorChangeSpeed) when it is needed.
+template <class Policy>
+SDL_Color evaluateBubbleColor(const Bubble &bubble, Uint32 frame)
+{
+    if constexpr (!Policy::colorAnimation)
+    {
+        return bubble.startColor;
+    }
+
+    float speed = Policy::uniformSpeed ? COLOR_CHANGE_SPEED : bubble.colorChangeSpeed;
+    float step = (frame - bubble.colorStartFrame) * speed * 255;
+
+    SDL_Color color;
+    color.r = interpolateChannel(bubble.startColor.r, bubble.targetColor.r, step);
+    color.g = interpolateChannel(bubble.startColor.g, bubble.targetColor.g, step);
+    color.b = interpolateChannel(bubble.startColor.b, bubble.targetColor.b, step);
+    color.a = 255; // Full opacity
+    return color;
+}
+
+// Function to start a new color transition once the current one has ended
+// The reached target becomes the new start color and a new random target is chosen.
+template <class Policy>
+void retargetBubbleColor(Bubble &bubble, Uint32 frame)
+{
+    // A bubble is retargeted at most once per frame, even if it is drawn in several views
+    if (!Policy::colorAnimation || frame == bubble.colorStartFrame ||
+        frame - bubble.colorStartFrame < getColorTransitionFrames<Policy>(bubble))
+    {
+        return;
+    }
+
+    bubble.startColor = bubble.targetColor;
+    bubble.colorStartFrame = frame;
+
+    bubble.targetColor.r = color_dis(gen);
+    bubble.targetColor.g = color_dis(gen);
+    bubble.targetColor.b = color_dis(gen);
+}
+
+// Function to draw every bubble inside a view with its full sprite
+template <class Policy>
+void drawBubbles(View &view)
+{
+    // Draw each bubble, evaluating its color on demand
+    for (auto &bubble : bubbles)
+    {
+        if (colorRefreshFrame)
+        {
+            retargetBubbleColor<Policy>(bubble, frameIndex);
+        }
+
+        SDL_Rect destRect;
+        destRect.x = static_cast<int>(bubble.position.x - view.origin.x);
+        destRect.y = static_cast<int>(bubble.position.y - view.origin.y);
+        destRect.w = bubble.limit_x;
+        destRect.h = bubble.limit_y;
+
+        // Skip the bubbles shown by other views
+        if (destRect.x + destRect.w <= 0 || destRect.x >= view.width ||
+            destRect.y + destRect.h <= 0 || destRect.y >= view.height)
+        {
+            continue;
+        }
+
+        if (colorRefreshFrame)
+        {
+            bubble.color = evaluateBubbleColor<Policy>(bubble, frameIndex);
+        }
+
+        // Apply color modulation to the bubble texture
+        SDL_Texture *texture = getSpriteLevel(view, destRect.w);
+        if (!texture)
+        {
+            drawLoadingPoint(view, destRect, bubble.color);
+            continue;
+        }
+        SDL_SetTextureColorMod(texture, bubble.color.r, bubble.color.g, bubble.color.b);
+
+        SDL_RenderCopy(view.renderer, texture, NULL, &destRect);
+    }
+}
+
+// Function to check if every tile touched by a rectangle is already hidden
+// Tiles are indexed in a coarse grid of OCCLUSION_TILE_SIZE pixels covering the screen.
+bool isRectOccluded(const SDL_Rect &rect, int tilesX, int tilesY)
+{
+    int x0 = std::max(rect.x / OCCLUSION_TILE_SIZE, 0);
+    int y0 = std::max(rect.y / OCCLUSION_TILE_SIZE, 0);
+    int x1 = std::min((rect.x + rect.w - 1) / OCCLUSION_TILE_SIZE, tilesX - 1);
+    int y1 = std::min((rect.y + rect.h - 1) / OCCLUSION_TILE_SIZE, tilesY - 1);
+
+    for (int ty = y0; ty <= y1; ty++)
+    {
+        for (int tx = x0; tx <= x1; tx++)
+        {
+            if (!tileCoverage[ty * tilesX + tx])
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Function to add a sprite to the coverage estimate
+// Only the tiles lying completely inside the sprite's opaque footprint (scaled to the drawn size)
+// are counted, so the estimate never marks a tile as covered when part of it could still be seen
+// through the sprite.
+void addRectCoverage(const SDL_Rect &rect, int tilesX, int tilesY)
+{
+    int left = rect.x + (spriteOpaqueRect.x * rect.w + spriteWidth - 1) / spriteWidth;
+    int top = rect.y + (spriteOpaqueRect.y * rect.h + spriteHeight - 1) / spriteHeight;
+    int right = rect.x + (spriteOpaqueRect.x + spriteOpaqueRect.w) * rect.w / spriteWidth;
+    int bottom = rect.y + (spriteOpaqueRect.y + spriteOpaqueRect.h) * rect.h / spriteHeight;
+
+    // Round inwards so that only fully covered tiles are counted
+    int x0 = std::max((left + OCCLUSION_TILE_SIZE - 1) / OCCLUSION_TILE_SIZE, 0);
+    int y0 = std::max((top + OCCLUSION_TILE_SIZE - 1) / OCCLUSION_TILE_SIZE, 0);
+    int x1 = std::min(right / OCCLUSION_TILE_SIZE, tilesX);
+    int y1 = std::min(bottom / OCCLUSION_TILE_SIZE, tilesY);
+
+    for (int ty = y0; ty < y1; ty++)
+    {
+        for (int tx = x0; tx < x1; tx++)
+        {
+            tileCoverage[ty * tilesX + tx] = 1;
+        }
+    }
+}
+
+// Function to draw the bubbles through the zoomable viewport of a view
+// Bubbles outside the viewport are culled, bubbles hidden under the opaque part of other sprites
+// are skipped, and bubbles only a few pixels big are drawn as a point instead of a sprite.
+template <class Policy>
+void drawBubblesCulled(View &view)
+{
+    int count = bubbles.size();
+    screenRects.resize(count);
+    isVisible.resize(count);
+
+    // Transform every bubble into screen space and cull it against the viewport
+    #pragma omp parallel for
+    for (int i = 0; i < count; i++)
+    {
+        const Bubble &bubble = bubbles[i];
+        SDL_Rect &rect = screenRects[i];
+        rect.x = static_cast<int>((bubble.position.x - view.origin.x) * view.zoom);
+        rect.y = static_cast<int>((bubble.position.y - view.origin.y) * view.zoom);
+        rect.w = std::max(static_cast<int>(bubble.limit_x * view.zoom), 1);
+        rect.h = std::max(static_cast<int>(bubble.limit_y * view.zoom), 1);
+
+        isVisible[i] = rect.x + rect.w > 0 && rect.x < view.width &&
+                       rect.y + rect.h > 0 && rect.y < view.height;
+    }
+
+    // Walk the bubbles from top to bottom (reverse draw order) to estimate occlusion
+    // Sprites without an opaque part (such as the ring-shaped bubble) never hide anything.
+    int tilesX = (view.width + OCCLUSION_TILE_SIZE - 1) / OCCLUSION_TILE_SIZE;
+    int tilesY = (view.height + OCCLUSION_TILE_SIZE - 1) / OCCLUSION_TILE_SIZE;
+    tileCoverage.assign(tilesX * tilesY, 0);
+    bool occlusion = view.spriteLevels > 0 && spriteOpaqueRect.w > 0;
+
+    for (int i = count - 1; occlusion && i >= 0; i--)
+    {
+        if (!isVisible[i])
+        {
+            continue;
+        }
+        if (isRectOccluded(screenRects[i], tilesX, tilesY))
+        {
+            isVisible[i] = false;
+            continue;
+        }
+        if (screenRects[i].w >= quality.lodPointSize)
+        {
+            addRectCoverage(screenRects[i], tilesX, tilesY);
+        }
+    }
+
+    // Draw the remaining bubbles in their original order
+    for (int i = 0; i < count; i++)
+    {
+        auto &bubble = bubbles[i];
+        if (colorRefreshFrame)
+        {
+            retargetBubbleColor<Policy>(bubble, frameIndex);
+        }
+        if (!isVisible[i])
+        {
+            continue;
+        }
+        if (colorRefreshFrame)
+        {
+            bubble.color = evaluateBubbleColor<Policy>(bubble, frameIndex);
+        }
+
+        const SDL_Rect &rect = screenRects[i];
+        if (rect.w < quality.lodPointSize)
+        {
+            // Cheaper LOD: a single point (or a tiny quad) with the bubble's color
+            SDL_SetRenderDrawColor(view.renderer, bubble.color.r, bubble.color.g, bubble.color.b, 255);
+            SDL_RenderFillRect(view.renderer, &rect);
+            continue;
+        }
+
+        // Apply color modulation to the mip level closest to the drawn size
+        SDL_Texture *texture = getSpriteLevel(view, rect.w);
+        if (!texture)
+        {
+            drawLoadingPoint(view, rect, bubble.color);
+            continue;
+        }
+        SDL_SetTextureColorMod(texture, bubble.color.r, bubble.color.g, bubble.color.b);
+
+        SDL_RenderCopy(view.renderer, texture, NULL, &rect);
+    }
+}
+
+// Function to zoom a view around a point given in screen coordinates
+void zoomViewport(View &view, float factor, glm::vec2 anchor)
+{
+    glm::vec2 worldAnchor = view.origin + anchor / view.zoom;
+    view.zoom = std::min(std::max(view.zoom * factor, 0.05f), 20.0f);
+    view.origin = worldAnchor - anchor / view.zoom;
+}
+
+// Function to create one window per display the world is shown on
+// Returns false if a window or renderer could not be created.
+bool createViews()
+{
+    int minX = displayBounds[0].x, minY = displayBounds[0].y;
+    for (auto &bounds : displayBounds)
+    {
+        minX = std::min(minX, bounds.x);
+        minY = std::min(minY, bounds.y);
+    }
+
+    for (auto &bounds : displayBounds)
+    {
+        View view;
+        view.width = bounds.w;
+        view.height = bounds.h;
+        view.origin = glm::vec2(bounds.x - minX, bounds.y - minY);
+        view.zoom = 1.0f;
+        view.spriteLevels = 0;
+
+        // Create a window (borderless and placed on its display when spanning several displays)
+        if (multiDisplayEnabled)
+        {
+            view.window = SDL_CreateWindow("FPS: 0", bounds.x, bounds.y, bounds.w, bounds.h,
+                                           SDL_WINDOW_SHOWN | SDL_WINDOW_BORDERLESS);
+        }
+        else
+        {
+            view.window = SDL_CreateWindow("FPS: 0",
+                                           SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                                           bounds.w, bounds.h,
+                                           SDL_WINDOW_SHOWN);
+        }
+
+        if (!view.window)
+        {
+            SDL_Log("Unable to create window: %s", SDL_GetError());
+            return false;
+        }
+
+        // Create a renderer
+        view.renderer = SDL_CreateRenderer(view.window, -1, SDL_RENDERER_ACCELERATED);
+
+        if (!view.renderer)
+        {
+            SDL_Log("Unable to create renderer: %s", SDL_GetError());
+            SDL_DestroyWindow(view.window);
+            return false;
+        }
+
+        // Center the initial zoom on the view
+        if (cullingEnabled)
+        {
+            zoomViewport(view, initialZoom, glm::vec2(view.width / 2, view.height / 2));
+        }
+
+        views.push_back(view);
+    }
+
+    return true;
+}
+
+// Function to destroy the windows created by createViews()
+void destroyViews()
+{
+    // The loader thread must not outlive the views it loads for
+    if (spriteLoader.joinable())
+    {
+        spriteLoader.join();
+    }
+
+    for (auto &view : views)
+    {
+        for (int level = 0; level < view.spriteLevels; level++)
+        {
+            SDL_DestroyTexture(view.sprites[level]);
+        }
+        SDL_DestroyRenderer(view.renderer);
+        SDL_DestroyWindow(view.window);
+    }
+    views.clear();
+}
+
+#if defined(__unix__)
+BubbleShm publisher = {};          // Shared-memory ring the completed frames are published to
+
+// Function to open the shared-memory ring, leaving room for the bubble count to double
+// publishFrame() moves to a larger ring if the simulation grows beyond that.
+bool openPublisher(int num_bubbles)
+{
+    if (!openBubbleShm(publisher, publishName, 2 * num_bubbles, WORLD_WIDTH, WORLD_HEIGHT))
+    {
+        perror("shm_open");
+        return false;
+    }
+    return true;
+}
+
+// Function to publish the bubbles of the completed frame to the shared-memory ring
+// Readers never block the simulation: they retry if the slot they copy is overwritten meanwhile.
+template <class Policy>
+void publishFrame()
+{
+    // Bubbles added at runtime may outgrow the ring: replace it with one twice the needed size
+    if (bubbles.size() > publisher.header->capacity && !growBubbleShm(publisher, 2 * bubbles.size()))
+    {
+        SDL_Log("Unable to grow the shared-memory ring %s, publishing stopped", publishName);
+        return;
+    }
+
+    // Drawing starts the next color transition of every bubble; without a view it is done here, so
+    // the published colors keep changing in headless runs too
+    if (Policy::colorAnimation && views.empty())
+    {
+        for (auto &bubble : bubbles)
+        {
+            retargetBubbleColor<Policy>(bubble, frameIndex);
+        }
+    }
+
+    BubbleShmSlot *slot = beginBubbleShmFrame(publisher, frameIndex);
+    BubbleSnapshot *data = getBubbleShmData(slot);
+    int count = std::min<int>(bubbles.size(), publisher.header->capacity);
+
+    #pragma omp parallel for
+    for (int i = 0; i < count; i++)
+    {
+        BoundingCircle circle = getBoundingCircle(bubbles[i]);
+        SDL_Color color = evaluateBubbleColor<Policy>(bubbles[i], frameIndex);
+        data[i] = {circle.center.x, circle.center.y, circle.radius, color.r, color.g, color.b, color.a};
+    }
+
+    endBubbleShmFrame(publisher, slot, count, bubbles.size());
+}
+#endif
+
+// Per-thread buffers filled by the lifecycle pass
+// Aligned to a cache line so that threads appending to their own buffer never share a line.
+struct alignas(64) LifecycleBuffer
+{
+    std::vector<int> popped;           // Indices of the bubbles popped by this thread
+    std::vector<Bubble> spawned;       // Bubbles spawned by this thread
+};
+std::vector<LifecycleBuffer> lifecycleBuffers;
+std::vector<char> isPopped;            // Whether each bubble popped in the current frame
+std::vector<size_t> chunkSurvivors;    // Prefix sum of the surviving bubbles of each chunk
+std::vector<size_t> spawnOffsets;      // Position of the bubbles spawned by each thread
+std::vector<Bubble> compactScratch;    // Scratch buffer used to rebuild `bubbles`
+Uint32 respawnSeed = 0;                // Seed of the respawned bubbles (drawn from `gen` on first use)
+
+// Function to remove the popped bubbles and insert the spawned ones at the end of a frame
+// Every thread counts the survivors of its own chunk; after an exclusive prefix sum it copies them
+// to their final position, then the spawned bubbles are appended. The array stays dense and in
+// order, and no lock is taken. Halo copies (ghosts) stay at the end of the array.
+// With regions, the survivors of each region stay contiguous, so the region ranges follow from the
+// number of survivors of every region; spawned bubbles join their region like migrants do.
+void compactBubbles()
+{
+    size_t poppedTotal = 0, spawnedTotal = 0;
+    for (auto &buffer : lifecycleBuffers)
+    {
+        poppedTotal += buffer.popped.size();
+        spawnedTotal += buffer.spawned.size();
+    }
+    if (poppedTotal == 0 && spawnedTotal == 0)
+    {
+        return;
+    }
+
+    int owned = bubbles.size() - ghostCount;
+    isPopped.assign(owned, 0);
+    for (auto &buffer : lifecycleBuffers)
+    {
+        for (int i : buffer.popped)
+        {
+            isPopped[i] = 1;
+        }
+    }
+
+    bool regions = broadPhase == BROAD_PHASE_REGIONS;
+    int regionCount = regions ? numRegions : 0;
+    size_t spawnedToRegions = 0;
+    if (regions)
+    {
+        for (auto &buffer : lifecycleBuffers)
+        {
+            for (auto &bubble : buffer.spawned)
+            {
+                regionInbox[getRegion(bubble)].push_back(bubble);
+            }
+            buffer.spawned.clear();
+        }
+        spawnedToRegions = spawnedTotal;
+        spawnedTotal = 0;
+    }
+
+    #pragma omp parallel
+    {
+        // Count the survivors of every region
+        #pragma omp for schedule(dynamic, 1)
+        for (int r = 0; r < regionCount; r++)
+        {
+            regionStayCount[r] = std::count(isPopped.begin() + regionStart[r],
+                                            isPopped.begin() + regionStart[r + 1], 0);
+        }
+
+        int threads = omp_get_num_threads(), thread = omp_get_thread_num();
+        int begin = static_cast<long>(owned) * thread / threads;
+        int end = static_cast<long>(owned) * (thread + 1) / threads;
+
+        #pragma omp single
+        chunkSurvivors.assign(threads + 1, 0);
+
+        size_t survivors = 0;
+        for (int i = begin; i < end; i++)
+        {
+            survivors += !isPopped[i];
+        }
+        chunkSurvivors[thread + 1] = survivors;
+
+        #pragma omp barrier
+        #pragma omp single
+        {
+            for (int t = 0; t < threads; t++)
+            {
+                chunkSurvivors[t + 1] += chunkSurvivors[t];
+            }
+            spawnOffsets.assign(lifecycleBuffers.size(), chunkSurvivors[threads]);
+            for (size_t b = 1; b < lifecycleBuffers.size(); b++)
+            {
+                spawnOffsets[b] = spawnOffsets[b - 1] + lifecycleBuffers[b - 1].spawned.size();
+            }
+            compactScratch.resize(chunkSurvivors[threads] + spawnedTotal + ghostCount);
+        }
+
+        size_t next = chunkSurvivors[thread];
+        for (int i = begin; i < end; i++)
+        {
+            if (!isPopped[i])
+            {
+                compactScratch[next++] = bubbles[i];
+            }
+        }
+
+        #pragma omp for
+        for (size_t b = 0; b < lifecycleBuffers.size(); b++)
+        {
+            std::copy(lifecycleBuffers[b].spawned.begin(), lifecycleBuffers[b].spawned.end(),
+                      compactScratch.begin() + spawnOffsets[b]);
+            lifecycleBuffers[b].spawned.clear();
+            lifecycleBuffers[b].popped.clear();
+        }
+    }
+
+    std::copy(bubbles.end() - ghostCount, bubbles.end(), compactScratch.end() - ghostCount);
+    bubbles.swap(compactScratch);
+
+    // Shrink every region to its survivors, then add the spawned bubbles to their regions
+    if (regions)
+    {
+        for (int r = 0; r < numRegions; r++)
+        {
+            regionStart[r + 1] = regionStart[r] + regionStayCount[r];
+        }
+        if (spawnedToRegions > 0)
+        {
+            mergeRegionInboxes();
+        }
+    }
+
+    // The order of the bubbles changed, so the tree must be rebuilt
+    bvhValid = false;
+}
+
+// Function to pop the bubbles that reached their collision or age limit
+// Runs in parallel: every thread records the bubbles it pops, and the bubbles it spawns to replace
+// them, in its own buffer; compactBubbles() applies both at the end of the frame.
+void updateLifecycle()
+{
+    int owned = bubbles.size() - ghostCount;
+
+    // Every thread needs its own buffer
+    size_t threads = omp_get_max_threads();
+    if (lifecycleBuffers.size() < threads)
+    {
+        lifecycleBuffers.resize(threads);
+    }
+    if (respawnSeed == 0)
+    {
+        respawnSeed = gen() | 1;
+    }
+
+    #pragma omp parallel
+    {
+        LifecycleBuffer &buffer = lifecycleBuffers[omp_get_thread_num()];
+
+        // Contiguous chunks in thread order keep the spawned bubbles in the order of the slots they replace
+        #pragma omp for schedule(static)
+        for (int i = 0; i < owned; i++)
+        {
+            const Bubble &bubble = bubbles[i];
+            bool popped = (popAfterCollisions > 0 && bubble.totalCollisions >= popAfterCollisions) ||
+                          (maxBubbleAge > 0 && frameIndex - bubble.birthFrame >= maxBubbleAge);
+            if (!popped)
+            {
+                continue;
+            }
+
+            buffer.popped.push_back(i);
+            if (respawnEnabled)
+            {
+                // Seeded from the frame and the popped bubble, so the replacement depends neither on the
+                // thread nor on where the broad phase keeps the bubble in the array
+                Uint32 x, y;
+                memcpy(&x, &bubble.position.x, sizeof(x));
+                memcpy(&y, &bubble.position.y, sizeof(y));
+                std::seed_seq seed = {respawnSeed, frameIndex, x, y, bubble.birthFrame};
+                std::mt19937 generator(seed);
+                Bubble replacement = makeBubble(generator);
+                replacement.limit_x = bubble.limit_x;
+                replacement.limit_y = bubble.limit_y;
+                buffer.spawned.push_back(replacement);
+            }
+        }
+    }
+
+    compactBubbles();
+}
+
+// Kernels instantiated for one policy
+struct Kernels
+{
+    void (*changeDirection[BROAD_PHASE_COUNT])(); // Movement and collisions, per broad phase
+    void (*checkCollisions)();                    // Collision cooldown update
+    void (*drawBubbles)(View &);                  // Full-sprite drawing
+    void (*drawBubblesCulled)(View &);            // Culled and LOD drawing
+#if defined(__unix__)
+    void (*publishFrame)();                       // Shared-memory publication
+#endif
+};
+
+// Function to gather the kernels of one policy
+template <class Policy>
+Kernels makeKernels()
+{
+    Kernels result = {{&changeBubbleDirection<Policy>, &changeBubbleDirectionGrid<Policy>,
+                       &changeBubbleDirectionRegions<Policy>, &changeBubbleDirectionBvh<Policy>},
+                      &checkCollisions<Policy>, &drawBubbles<Policy>, &drawBubblesCulled<Policy>,
+#if defined(__unix__)
+                      &publishFrame<Policy>,
+#endif
+                     };
+    return result;
+}
+
+// Policy selected by each bit of a kernel table index
+template <size_t Index>
+using PolicyAt = KernelPolicy<(Index & 1) != 0, (Index & 2) != 0, (Index & 4) != 0, (Index & 8) != 0>;
+
+// Function to instantiate the kernels of every policy
+template <size_t... Indices>
+const Kernels *buildKernelTable(std::index_sequence<Indices...>)
+{
+    static const Kernels table[] = {makeKernels<PolicyAt<Indices>>()...};
+    return table;
+}
+
+Kernels kernels;                   // Kernels matching the current settings
+Kernels kernelsWithoutCollisions;  // Same kernels for the steps that skip collisions
+
+// Function to pick the kernels matching the current settings
+// Called once at startup and again whenever a runtime control changes one of the settings.
+void selectKernels()
+{
+    static const Kernels *table = buildKernelTable(std::make_index_sequence<16>());
+    int index = (collisionsEnabled ? 1 : 0) | (wrapWallsEnabled ? 2 : 0) |
+                (colorAnimationEnabled ? 4 : 0) | (randomColorSpeedEnabled ? 0 : 8);
+    kernels = table[index];
+    kernelsWithoutCollisions = table[index & ~1];
+}
+
+// Function to add a phase duration to its smoothed average
+void recordPhase(double &average, double start)
+{
+    average = 0.9 * average + 0.1 * (omp_get_wtime() - start) * 1000.0;
+}
+
+// Function to advance the simulation by one step
+void stepSimulation()
+{
+    double start = omp_get_wtime();
+
+    // Collisions may only be resolved every few steps when the adaptive controller lowers quality
+    const Kernels &active = frameIndex % quality.collisionInterval == 0 ? kernels : kernelsWithoutCollisions;
+
+    // Update bubble directions
+    active.changeDirection[broadPhase]();
+    recordPhase(phaseTimes.movement, start);
+
+    start = omp_get_wtime();
+    active.checkCollisions(); // Check and deactivate collisions if necessary
+    frameIndex++;
+    recordPhase(phaseTimes.cooldown, start);
+
+    // Pop and respawn bubbles
+    if (popAfterCollisions > 0 || maxBubbleAge > 0)
+    {
+        updateLifecycle();
+    }
+
+#if defined(__unix__)
+    if (publisher.header)
+    {
+        start = omp_get_wtime();
+        kernels.publishFrame();
+        recordPhase(phaseTimes.publish, start);
+    }
+#endif
+}
+
+// Function to switch the broad-phase algorithm
+void setBroadPhase(BroadPhase phase)
+{
+    broadPhase = phase;
+    bvhValid = false;
+    if (broadPhase == BROAD_PHASE_REGIONS)
+    {
+        if (numRegions == 0)
+        {
+            numRegions = omp_get_max_threads();
+        }
+        assignRegions();
+    }
+}
+
+// Function to add bubbles while the simulation is running
+void addBubbles(int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        spawnBubble();
+    }
+
+    // New bubbles are appended at the end and must be sorted into their regions
+    if (broadPhase == BROAD_PHASE_REGIONS)
+    {
+        assignRegions();
+    }
+}
+
+// Function to remove the most recently spawned bubbles while the simulation is running
+// Bubbles are picked by their birth frame, not by their place in the array: the region broad phase
+// sorts the array by region, so cutting its tail would empty the right-hand edge of the world.
+// Bubbles born in the same frame (such as the initial ones) are thinned evenly over the array.
+void removeBubbles(int count)
+{
+    count = std::min<int>(count, bubbles.size());
+    if (count == 0)
+    {
+        return;
+    }
+
+    // Find the birth frame of the oldest bubble to remove
+    std::vector<Uint32> births(bubbles.size());
+    for (size_t i = 0; i < bubbles.size(); i++)
+    {
+        births[i] = bubbles[i].birthFrame;
+    }
+    std::nth_element(births.begin(), births.end() - count, births.end());
+    Uint32 threshold = *(births.end() - count);
+
+    // Every younger bubble goes; of those born at the threshold, only as many as still needed
+    int younger = std::count_if(births.begin(), births.end(), [&](Uint32 birth) { return birth > threshold; });
+    int tied = std::count(births.begin(), births.end(), threshold);
+    int tiedToRemove = count - younger;
+
+    size_t kept = 0;
+    int tiedSeen = 0;
+    for (size_t i = 0; i < bubbles.size(); i++)
+    {
+        bool removed = bubbles[i].birthFrame > threshold;
+        if (bubbles[i].birthFrame == threshold)
+        {
+            // Remove a tied bubble whenever the evenly spread quota moves on to the next one
+            removed = static_cast<long long>(tiedSeen + 1) * tiedToRemove / tied >
+                      static_cast<long long>(tiedSeen) * tiedToRemove / tied;
+            tiedSeen++;
+        }
+        if (!removed)
+        {
+            bubbles[kept++] = bubbles[i];
+        }
+    }
+    bubbles.resize(kept);
+    bvhValid = false;    // The remaining bubbles moved in the array
+
+    if (broadPhase == BROAD_PHASE_REGIONS)
+    {
+        assignRegions();
+    }
+}
+
+// Function to handle the runtime keyboard controls
+void handleKeyDown(SDL_Keycode key)
+{
+    if (key == SDLK_PLUS || key == SDLK_EQUALS || key == SDLK_KP_PLUS)
+    {
+        addBubbles(BUBBLE_BATCH);
+    }
+    else if (key == SDLK_MINUS || key == SDLK_KP_MINUS)
+    {
+        removeBubbles(BUBBLE_BATCH);
+    }
+    else if (key >= SDLK_1 && key <= SDLK_9)
+    {
+        omp_set_num_threads(key - SDLK_0);
+    }
+    else if (key == SDLK_0)
+    {
+        omp_set_num_threads(omp_get_num_procs());
+    }
+    else if (key == SDLK_c)
+    {
+        collisionsEnabled = !collisionsEnabled;
+        selectKernels();
+    }
+    else if (key == SDLK_b)
+    {
+        setBroadPhase(static_cast<BroadPhase>((broadPhase + 1) % BROAD_PHASE_COUNT));
+    }
+    else if (key == SDLK_o)
+    {
+        overlayEnabled = !overlayEnabled;
+    }
+}
+
+// Function to get the 3x5 bitmap of an overlay character
+// Each octal digit is one row of 3 pixels, top row first; only the characters used by the overlay
+// are defined.
+Uint16 getOverlayGlyph(char c)
+{
+    const char *chars = "0123456789.ABCDELMOPRSUVW";
+    static const Uint16 glyphs[] = {
+        075557, 026227, 071747, 071717, 055711, 074717, 074757, 071111, 075757, 075717, 000002,
+        025755, 065656, 034443, 065556, 074647, 044447, 057755, 025552, 065644, 065655, 034216,
+        055557, 055552, 055775};
+    const char *found = c ? strchr(chars, c) : NULL;
+    return found ? glyphs[found - chars] : 0;
+}
+
+// Function to draw a line of text with the overlay's bitmap font, `scale` pixels per font pixel
+void drawOverlayText(View &view, const char *text, int x, int y, int scale)
+{
+    std::vector<SDL_Rect> pixels;
+    for (int k = 0; text[k]; k++)
+    {
+        Uint16 glyph = getOverlayGlyph(text[k]);
+        for (int bit = 0; bit < 15; bit++)
+        {
+            if (glyph & (1 << (14 - bit)))
+            {
+                pixels.push_back({x + (k * 4 + bit % 3) * scale, y + bit / 3 * scale, scale, scale});
+            }
+        }
+    }
+    SDL_RenderFillRects(view.renderer, pixels.data(), pixels.size());
+}
+
+// Function to draw the per-phase timings as labelled horizontal bars
+// Every row shows the phase name and its time in ms, then a bar 20 pixels per millisecond long;
+// the white line marks the frame budget. The labels keep the overlay readable on borderless
+// windows, which have no title bar.
+void drawOverlay(View &view)
+{
+    const double phases[] = {phaseTimes.movement, phaseTimes.cooldown, phaseTimes.publish,
+                             phaseTimes.draw, phaseTimes.present};
+    const char *labels[] = {"MOVE", "COOL", "PUB", "DRAW", "PRES"};
+    const SDL_Color colors[] = {{230, 80, 80, 255}, {230, 180, 60, 255}, {90, 200, 90, 255},
+                                {80, 150, 230, 255}, {180, 100, 220, 255}};
+    const int pixelsPerMs = 20;
+    const int barLeft = 10 + 13 * 8;   // Room for "NAME 00.00MS" in 2x-scaled glyphs
+
+    SDL_Rect panel = {6, 6, barLeft - 8, 5 * 14 + 2};
+    SDL_SetRenderDrawColor(view.renderer, 0, 0, 0, 255);
+    SDL_RenderFillRect(view.renderer, &panel);
+
+    for (int k = 0; k < 5; k++)
+    {
+        char text[32];
+        snprintf(text, sizeof(text), "%-4s %5.2fMS", labels[k], std::min(phases[k], 99.99));
+        SDL_SetRenderDrawColor(view.renderer, colors[k].r, colors[k].g, colors[k].b, 255);
+        drawOverlayText(view, text, 10, 10 + k * 14, 2);
+
+        SDL_Rect bar = {barLeft, 10 + k * 14, std::max(static_cast<int>(phases[k] * pixelsPerMs), 1), 10};
+        SDL_RenderFillRect(view.renderer, &bar);
+    }
+
+    SDL_Rect budget = {barLeft + pixelsPerMs * 1000 / FPS, 6, 2, 5 * 14 + 4};
+    SDL_SetRenderDrawColor(view.renderer, 255, 255, 255, 255);
+    SDL_RenderFillRect(view.renderer, &budget);
+}
+
+// Function to adjust the quality knobs and thread count to hold the frame budget
+// Every ADAPT_INTERVAL frames the mean frame time of those frames is compared with the budget
+// (1000 / FPS ms); a change is only made once ADAPT_CONFIRM consecutive windows agree, and the
+// window after a change is discarded while the new settings settle. Over budget, the controller
+// first adds threads, then lowers the quality of the most expensive phase: collisions are resolved
+// less often when moving dominates, and colors are refreshed less often and more sprites are drawn
+// as points when drawing dominates. With headroom it restores the quality first and then drops
+// threads, leaving the cores idle for the rest of the frame. A thread is only dropped if the frame
+// would still fit under the headroom with the remaining threads, so it is not added straight back.
+void adaptQuality(double frameTime)
+{
+    static double windowTime = 0;
+    static int framesInWindow = 0;
+    static int overBudgetWindows = 0;
+    static int headroomWindows = 0;
+    static bool settling = false;
+
+    windowTime += frameTime;
+    if (++framesInWindow < ADAPT_INTERVAL)
+    {
+        return;
+    }
+    double averageFrameTime = windowTime / framesInWindow;
+    windowTime = 0;
+    framesInWindow = 0;
+
+    // The first window after a change still mixes the old and new settings
+    if (settling)
+    {
+        settling = false;
+        return;
+    }
+
+    double budget = 1000.0 / FPS;
+    overBudgetWindows = averageFrameTime > ADAPT_OVER_BUDGET * budget ? overBudgetWindows + 1 : 0;
+    headroomWindows = averageFrameTime < ADAPT_HEADROOM * budget ? headroomWindows + 1 : 0;
+    if (overBudgetWindows < ADAPT_CONFIRM && headroomWindows < ADAPT_CONFIRM)
+    {
+        return;
+    }
+
+    QualitySettings previous = quality;
+    int threads = omp_get_max_threads();
+    int newThreads = threads;
+    bool movementDominates = phaseTimes.movement + phaseTimes.cooldown >= phaseTimes.draw + phaseTimes.present;
+
+    if (overBudgetWindows >= ADAPT_CONFIRM)
+    {
+        if (threads < omp_get_num_procs())
+        {
+            newThreads = threads + 1;
+        }
+        else if (movementDominates && quality.collisionInterval < MAX_COLLISION_INTERVAL)
+        {
+            quality.collisionInterval++;
+        }
+        else if (quality.colorInterval < MAX_COLOR_INTERVAL)
+        {
+            quality.colorInterval *= 2;
+        }
+        else if (cullingEnabled && quality.lodPointSize < MAX_LOD_POINT_SIZE)
+        {
+            quality.lodPointSize *= 2;
+        }
+        else if (quality.collisionInterval < MAX_COLLISION_INTERVAL)
+        {
+            quality.collisionInterval++;
+        }
+    }
+    else
+    {
+        if (quality.lodPointSize > LOD_POINT_SIZE)
+        {
+            quality.lodPointSize /= 2;
+        }
+        else if (quality.colorInterval > 1)
+        {
+            quality.colorInterval /= 2;
+        }
+        else if (quality.collisionInterval > 1)
+        {
+            quality.collisionInterval--;
+        }
+        else if (threads > 1 && averageFrameTime * threads / (threads - 1) < ADAPT_HEADROOM * budget)
+        {
+            // Full quality with headroom: fewer threads, more idle time per frame
+            newThreads = threads - 1;
+        }
+    }
+
+    if (newThreads != threads)
+    {
+        omp_set_num_threads(newThreads);
+    }
+    if (newThreads != threads || quality.collisionInterval != previous.collisionInterval ||
+        quality.colorInterval != previous.colorInterval || quality.lodPointSize != previous.lodPointSize)
+    {
+        overBudgetWindows = 0;
+        headroomWindows = 0;
+        settling = true;
+    }
+}
+
+// Function to describe the runtime settings and phase timings for the window title
+std::string describeSettings()
+{
+    std::string text = " | Bubbles: " + std::to_string(bubbles.size()) +
+                       " | Threads: " + std::to_string(omp_get_max_threads()) +
+                       " | Broad phase: " + BROAD_PHASE_NAMES[broadPhase] +
+                       " | Collisions: " + (collisionsEnabled ? "on" : "off");
+    if (broadPhase == BROAD_PHASE_BVH)
+    {
+        text += " | Tree rebuilds: " + std::to_string(bvhRebuilds);
+    }
+    if (adaptiveEnabled)
+    {
+        text += " | Collision interval: " + std::to_string(quality.collisionInterval) +
+                " | Color interval: " + std::to_string(quality.colorInterval) +
+                " | LOD: " + std::to_string(quality.lodPointSize) + " px";
+    }
+    if (overlayEnabled)
+    {
+        text += " | Move " + std::to_string(phaseTimes.movement) +
+                " / Cooldown " + std::to_string(phaseTimes.cooldown) +
+                " / Publish " + std::to_string(phaseTimes.publish) +
+                " / Draw " + std::to_string(phaseTimes.draw) +
+                " / Present " + std::to_string(phaseTimes.present) + " ms";
+    }
+    return text;
+}
+
+// Function to render bubbles on the screen
+void render()
+{
+    uploadSprites();
+    stepSimulation();
+    colorRefreshFrame = frameIndex % quality.colorInterval == 0;
+
+    double drawTime = 0, presentTime = 0;
+    for (auto &view : views)
+    {
+        double start = omp_get_wtime();
+
+        // Clear the screen with a black background
+        SDL_SetRenderDrawColor(view.renderer, 0, 0, 0, 255);
+        SDL_RenderClear(view.renderer);
+
+        if (cullingEnabled)
+        {
+            kernels.drawBubblesCulled(view);
+        }
+        else
+        {
+            kernels.drawBubbles(view);
+        }
+
+        if (overlayEnabled && &view == &views[0])
+        {
+            drawOverlay(view);
+        }
+        double presentStart = omp_get_wtime();
+        drawTime += presentStart - start;
+
+        // Present the rendered frame on the screen
+        SDL_RenderPresent(view.renderer);
+        presentTime += omp_get_wtime() - presentStart;
+    }
+
+    phaseTimes.draw = 0.9 * phaseTimes.draw + 0.1 * drawTime * 1000.0;
+    phaseTimes.present = 0.9 * phaseTimes.present + 0.1 * presentTime * 1000.0;
+}
+
+// Function to run the simulation without a window for a fixed number of steps
+int runHeadless(int num_bubbles)
+{
+    WORLD_WIDTH = requestedWorldWidth > 0 ? requestedWorldWidth : HEADLESS_WORLD_WIDTH;
+    WORLD_HEIGHT = requestedWorldHeight > 0 ? requestedWorldHeight : HEADLESS_WORLD_HEIGHT;
+
+    spawn_dis_x = std::uniform_int_distribution<>(100, std::max(WORLD_WIDTH - 200, 100));
+    spawn_dis_y = std::uniform_int_distribution<>(100, std::max(WORLD_HEIGHT - 200, 100));
+
+    for (int i = 0; i < num_bubbles; i++)
+    {
+        spawnBubble();
+    }
+
+    if (broadPhase == BROAD_PHASE_REGIONS)
+    {
+        setBroadPhase(BROAD_PHASE_REGIONS);
+    }
+
+#if defined(__unix__)
+    if (publishName && !openPublisher(num_bubbles))
+    {
+        return 1;
+    }
+#endif
+
+    // Time every step so that the tail of the distribution can be reported as well
+    std::vector<double> stepTimes(headlessSteps);
+    double start = omp_get_wtime();
+    for (int step = 0; step < headlessSteps; step++)
+    {
+        double stepStart = omp_get_wtime();
+        stepSimulation();
+        stepTimes[step] = (omp_get_wtime() - stepStart) * 1000.0;
+    }
+    double elapsed = omp_get_wtime() - start;
+
+    std::sort(stepTimes.begin(), stepTimes.end());
+    double p95 = stepTimes[std::min<size_t>(headlessSteps * 95 / 100, headlessSteps - 1)];
+
+    std::cout << "Steps: " << headlessSteps << " | Bubbles: " << bubbles.size()
+              << " | Threads: " << omp_get_max_threads()
+              << " | Avg Step Time: " << std::to_string(elapsed * 1000.0 / headlessSteps) << " ms"
+              << " | P95 Step Time: " << std::to_string(p95) << " ms"
+              << " | Max Step Time: " << std::to_string(stepTimes.back()) << " ms" << std::endl;
+
+#if defined(__unix__)
+    closeBubbleShm(publisher);
+#endif
+    return 0;
+}
+
+#if defined(__unix__)
+// Statistics sent by every worker process to the coordinator at the end of a distributed run
+struct WorkerStats
+{
+    int32_t rank;            // Index of the worker's strip
+    int32_t bubbles;         // Number of bubbles owned at the end of the run
+    int64_t migrantsSent;    // Number of bubbles handed over to a neighbour
+    int64_t haloSent;        // Number of halo copies sent to neighbours
+    double stepTime;         // Time spent stepping the simulation, in seconds
+    double exchangeTime;     // Time spent exchanging bubbles with neighbours, in seconds
+};
+
+// Function to write a whole buffer to a socket
+bool sendAll(int fd, const void *data, size_t size)
+{
+    const char *bytes = static_cast<const char *>(data);
+    while (size > 0)
+    {
+        ssize_t written = write(fd, bytes, size);
+        if (written <= 0)
+        {
+            return false;
+        }
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+// Function to read a whole buffer from a socket
+bool recvAll(int fd, void *data, size_t size)
+{
+    char *bytes = static_cast<char *>(data);
+    while (size > 0)
+    {
+        ssize_t received = read(fd, bytes, size);
+        if (received <= 0)
+        {
+            return false;
+        }
+        bytes += received;
+        size -= received;
+    }
+    return true;
+}
+
+// Function to send a list of bubbles
+// The message is the count followed by the raw Bubble data.
+bool sendBubbles(int fd, const std::vector<Bubble> &list)
+{
+    uint32_t count = static_cast<uint32_t>(list.size());
+    return sendAll(fd, &count, sizeof(count)) && sendAll(fd, list.data(), list.size() * sizeof(Bubble));
+}
+
+// Function to receive a list of bubbles sent by sendBubbles()
+bool recvBubbles(int fd, std::vector<Bubble> &list)
+{
+    uint32_t count;
+    if (!recvAll(fd, &count, sizeof(count)))
+    {
+        return false;
+    }
+    list.resize(count);
+    return recvAll(fd, list.data(), list.size() * sizeof(Bubble));
+}
+
+// Function to exchange a list of bubbles with one neighbour
+// The lower strip always sends first and the upper strip always receives first, so two
+// neighbours never block on each other with full socket buffers.
+bool exchangeWithNeighbour(int fd, bool sendFirst, const std::vector<Bubble> &out, std::vector<Bubble> &in)
+{
+    if (sendFirst)
+    {
+        return sendBubbles(fd, out) && recvBubbles(fd, in);
+    }
+    return recvBubbles(fd, in) && sendBubbles(fd, out);
+}
+
+// Function to exchange one list with the strip above and one with the strip below
+// Received bubbles are appended to `in`. Returns false if a neighbour is gone.
+bool exchangeWithNeighbours(int rank, int upFd, int downFd, const std::vector<Bubble> &outUp,
+                            const std::vector<Bubble> &outDown, std::vector<Bubble> &in,
+                            std::vector<Bubble> &scratch)
+{
+    // Exchange with the strip above (this worker is the upper side) and then with the one below
+    if (upFd >= 0)
+    {
+        if (!exchangeWithNeighbour(upFd, false, outUp, scratch))
+        {
+            SDL_Log("Worker %d lost the connection to worker %d", rank, rank - 1);
+            return false;
+        }
+        in.insert(in.end(), scratch.begin(), scratch.end());
+    }
+    if (downFd >= 0)
+    {
+        if (!exchangeWithNeighbour(downFd, true, outDown, scratch))
+        {
+            SDL_Log("Worker %d lost the connection to worker %d", rank, rank + 1);
+            return false;
+        }
+        in.insert(in.end(), scratch.begin(), scratch.end());
+    }
+    return true;
+}
+
+// Function to run one worker of a distributed simulation
+// The worker owns the bubbles whose center lies in the strip [top, bottom) of the world; it starts
+// from its share of the bubbles spawned by the coordinator. Before each step the halo bubbles
+// received from its neighbours are appended as read-only ghosts, so collisions across the boundary
+// are still detected. After each step, bubbles that left the strip are handed to the neighbour that
+// now owns them; the halo is only built after they arrived, so a bubble that just crossed a boundary
+// is still seen from the strip it left. At the end the worker sends its statistics and its bubbles
+// to the coordinator.
+int runWorker(int rank, int processes, int upFd, int downFd, int resultFd)
+{
+    float top = static_cast<float>(WORLD_HEIGHT) * rank / processes;
+    float bottom = static_cast<float>(WORLD_HEIGHT) * (rank + 1) / processes;
+    float haloDistance = std::max(spriteWidth, spriteHeight) + 2.0f;
+
+    // Keep this worker's share of the bubbles; the outer strips also own anything beyond the world
+    size_t kept = 0;
+    for (size_t i = 0; i < bubbles.size(); i++)
+    {
+        float centerY = getBoundingCircle(bubbles[i]).center.y;
+        if ((rank == 0 || centerY >= top) && (rank == processes - 1 || centerY < bottom))
+        {
+            bubbles[kept++] = bubbles[i];
+        }
+    }
+    bubbles.resize(kept);
+    bvhValid = false;
+
+    // Respawned bubbles appear inside the strip
+    int spawnTop = std::max(static_cast<int>(top), 100);
+    int spawnBottom = std::min(static_cast<int>(bottom) - spriteHeight, WORLD_HEIGHT - 200);
+    spawn_dis_y = std::uniform_int_distribution<>(spawnTop, std::max(spawnBottom, spawnTop));
+
+    WorkerStats stats = {};
+    stats.rank = rank;
+
+    std::vector<Bubble> ghosts, upMigrants, downMigrants, upHalo, downHalo, scratch;
+
+    for (int step = 0; step < headlessSteps; step++)
+    {
+        double exchangeStart = omp_get_wtime();
+
+        // Send the owned bubbles near each boundary as the neighbours' halo
+        upHalo.clear(), downHalo.clear();
+        for (const auto &bubble : bubbles)
+        {
+            float centerY = getBoundingCircle(bubble).center.y;
+            if (centerY < top + haloDistance && upFd >= 0)
+            {
+                upHalo.push_back(bubble);
+            }
+            if (centerY >= bottom - haloDistance && downFd >= 0)
+            {
+                downHalo.push_back(bubble);
+            }
+        }
+        stats.haloSent += upHalo.size() + downHalo.size();
+
+        ghosts.clear();
+        if (!exchangeWithNeighbours(rank, upFd, downFd, upHalo, downHalo, ghosts, scratch))
+        {
+            return 1;
+        }
+
+        double stepStart = omp_get_wtime();
+        stats.exchangeTime += stepStart - exchangeStart;
+
+        // Step the owned bubbles against the owned and halo bubbles
+        bubbles.insert(bubbles.end(), ghosts.begin(), ghosts.end());
+        ghostCount = ghosts.size();
+        bvhValid = false;    // The halo is replaced every step
+        stepSimulation();
+        bubbles.resize(bubbles.size() - ghostCount);
+        ghostCount = 0;
+
+        // Hand the bubbles that left the strip to their new owners
+        upMigrants.clear(), downMigrants.clear();
+        size_t kept = 0;
+        for (size_t i = 0; i < bubbles.size(); i++)
+        {
+            const Bubble &bubble = bubbles[i];
+            float centerY = getBoundingCircle(bubble).center.y;
+            if (centerY < top && upFd >= 0)
+            {
+                upMigrants.push_back(bubble);
+                continue;
+            }
+            if (centerY >= bottom && downFd >= 0)
+            {
+                downMigrants.push_back(bubble);
+                continue;
+            }
+            bubbles[kept++] = bubble;
+        }
+        bubbles.resize(kept);
+        stats.migrantsSent += upMigrants.size() + downMigrants.size();
+
+        exchangeStart = omp_get_wtime();
+        stats.stepTime += exchangeStart - stepStart;
+        if (!exchangeWithNeighbours(rank, upFd, downFd, upMigrants, downMigrants, bubbles, scratch))
+        {
+            return 1;
+        }
+        stats.exchangeTime += omp_get_wtime() - exchangeStart;
+    }
+
+    stats.bubbles = bubbles.size();
+    return sendAll(resultFd, &stats, sizeof(stats)) && sendBubbles(resultFd, bubbles) ? 0 : 1;
+}
+
+// Function to run the current bubbles split into `processes` worker processes
+// The coordinator (this process) forks one worker per horizontal strip, connects neighbouring
+// workers with Unix domain sockets and gathers the statistics and final bubbles of every worker.
+// It must not start any OpenMP parallel region before forking. Returns false if a worker failed.
+bool runWorkers(int processes, std::vector<WorkerStats> &stats, std::vector<Bubble> &finalBubbles)
+{
+    // links[k] connects worker k (side 0) with worker k + 1 (side 1)
+    std::vector<int> links(2 * processes, -1);
+    std::vector<int> resultLinks(2 * processes, -1);
+    for (int k = 0; k < processes; k++)
+    {
+        if ((k + 1 < processes && socketpair(AF_UNIX, SOCK_STREAM, 0, &links[2 * k]) != 0) ||
+            socketpair(AF_UNIX, SOCK_STREAM, 0, &resultLinks[2 * k]) != 0)
+        {
+            perror("socketpair");
+            return false;
+        }
+    }
+
+    bool succeeded = true;
+    std::vector<pid_t> workers;
+    for (int rank = 0; rank < processes; rank++)
+    {
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            perror("fork");
+            succeeded = false;
+            break;
+        }
+
+        if (pid == 0)
+        {
+            int upFd = rank > 0 ? links[2 * (rank - 1) + 1] : -1;
+            int downFd = links[2 * rank];
+            int resultFd = resultLinks[2 * rank + 1];
+
+            // Close every socket end that belongs to another process
+            for (int fd : links)
+            {
+                if (fd >= 0 && fd != upFd && fd != downFd)
+                {
+                    close(fd);
+                }
+            }
+            for (int fd : resultLinks)
+            {
+                if (fd >= 0 && fd != resultFd)
+                {
+                    close(fd);
+                }
+            }
+
+            _exit(runWorker(rank, processes, upFd, downFd, resultFd));
+        }
+        workers.push_back(pid);
+    }
+
+    // The coordinator only keeps its side of the result sockets; the workers that did start see
+    // their missing neighbours hang up and exit
+    for (int fd : links)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+    for (int rank = 0; rank < processes; rank++)
+    {
+        close(resultLinks[2 * rank + 1]);
+    }
+
+    // Gather the statistics and bubbles of every worker
+    stats.clear();
+    finalBubbles.clear();
+    std::vector<Bubble> received;
+    for (int rank = 0; rank < static_cast<int>(workers.size()); rank++)
+    {
+        WorkerStats workerStats;
+        if (!recvAll(resultLinks[2 * rank], &workerStats, sizeof(workerStats)) ||
+            !recvBubbles(resultLinks[2 * rank], received))
+        {
+            std::cout << "Worker " << rank << " did not report its results" << std::endl;
+            succeeded = false;
+        }
+        else
+        {
+            stats.push_back(workerStats);
+            finalBubbles.insert(finalBubbles.end(), received.begin(), received.end());
+        }
+    }
+    for (int rank = 0; rank < processes; rank++)
+    {
+        close(resultLinks[2 * rank]);
+    }
+
+    for (pid_t pid : workers)
+    {
+        int workerStatus;
+        if (waitpid(pid, &workerStatus, 0) < 0 || !WIFEXITED(workerStatus) || WEXITSTATUS(workerStatus) != 0)
+        {
+            succeeded = false;
+        }
+    }
+    return succeeded;
+}
+
+// Function to run a headless simulation split into numProcesses worker processes
+// The coordinator spawns every bubble, so the run starts from the same state as a single-process
+// run with the same seed, then prints the statistics gathered from the workers.
+int runDistributed(int num_bubbles)
+{
+    WORLD_WIDTH = requestedWorldWidth > 0 ? requestedWorldWidth : HEADLESS_WORLD_WIDTH;
+    WORLD_HEIGHT = requestedWorldHeight > 0 ? requestedWorldHeight : HEADLESS_WORLD_HEIGHT;
+
+    spawn_dis_x = std::uniform_int_distribution<>(100, std::max(WORLD_WIDTH - 200, 100));
+    spawn_dis_y = std::uniform_int_distribution<>(100, std::max(WORLD_HEIGHT - 200, 100));
+    for (int i = 0; i < num_bubbles; i++)
+    {
+        spawnBubble();
+    }
+
+    // Strips replace the vertical regions in distributed mode
+    numRegions = 0;
+    if (broadPhase == BROAD_PHASE_REGIONS)
+    {
+        broadPhase = BROAD_PHASE_BRUTE_FORCE;
+    }
+
+    // Split the available threads between the workers
+    omp_set_num_threads(std::max(omp_get_max_threads() / numProcesses, 1));
+
+    std::vector<WorkerStats> workerStats;
+    std::vector<Bubble> finalBubbles;
+    int status = runWorkers(numProcesses, workerStats, finalBubbles) ? 0 : 1;
+
+    long totalBubbles = 0, totalMigrants = 0, totalHalo = 0;
+    double maxStepTime = 0, maxExchangeTime = 0;
+    for (const auto &stats : workerStats)
+    {
+        std::cout << "Worker " << stats.rank << " | Bubbles: " << stats.bubbles
+                  << " | Avg Step Time: " << std::to_string(stats.stepTime * 1000.0 / headlessSteps) << " ms"
+                  << " | Avg Exchange Time: " << std::to_string(stats.exchangeTime * 1000.0 / headlessSteps) << " ms"
+                  << std::endl;
+
+        totalBubbles += stats.bubbles;
+        totalMigrants += stats.migrantsSent;
+        totalHalo += stats.haloSent;
+        maxStepTime = std::max(maxStepTime, stats.stepTime);
+        maxExchangeTime = std::max(maxExchangeTime, stats.exchangeTime);
+    }
+
+    std::cout << "Steps: " << headlessSteps << " | Processes: " << numProcesses << " | Bubbles: " << totalBubbles
+              << " | Migrants: " << totalMigrants << " | Halo: " << totalHalo
+              << " | Avg Step Time: " << std::to_string((maxStepTime + maxExchangeTime) * 1000.0 / headlessSteps) << " ms"
+              << std::endl;
+    return status;
+}
+#endif
+
+// Settings of one case of the parallel-versus-reference check
+struct VerifyCase
+{
+    int bubbles;              // Number of bubbles
+    int threads;              // Number of OpenMP threads of the parallel run
+    omp_sched_t schedule;     // Schedule of the schedule(runtime) loops in the parallel run
+    int chunk;                // Chunk size of the schedule (0 = default)
+    BroadPhase broadPhase;    // Broad-phase algorithm
+    int regions;              // Number of regions (regions broad phase)
+    Uint32 seed;              // Seed of the bubbles
+    int processes;            // Number of worker processes of the parallel run (0 = single process)
+};
+
+const char *SCHEDULE_NAMES[] = {"", "static", "dynamic", "guided", "auto"};
+const float VERIFY_TOLERANCE = 1e-3f;  // Largest accepted difference of a position or direction
+
+// Function to run one case from its seed with the given broad phase, threads and schedule
+// The run starts from the same state every time. The final bubbles are returned sorted by position,
+// since the region broad phase and the workers keep them in a different order than the others.
+// With `processes` > 0 the case runs in that many worker processes (each with `threads` threads),
+// and this process never enters a parallel region, so it can keep forking new workers.
+std::vector<Bubble> runVerifyCase(const VerifyCase &test, BroadPhase phase, int threads, omp_sched_t schedule,
+                                  int chunk, int processes)
+{
+    gen.seed(test.seed);
+    respawnSeed = 0;
+    frameIndex = 0;
+    bubbles.clear();
+    for (int i = 0; i < test.bubbles; i++)
+    {
+        spawnBubble();
+    }
+
+    omp_set_num_threads(threads);
+    omp_set_schedule(schedule, chunk);
+    numRegions = test.regions;
+
+    std::vector<Bubble> result;
+#if defined(__unix__)
+    if (processes > 0)
+    {
+        numRegions = 0;
+        setBroadPhase(phase);
+        std::vector<WorkerStats> stats;
+        if (!runWorkers(processes, stats, result))
+        {
+            result.clear();
+        }
+    }
+    else
+#endif
+    {
+        setBroadPhase(phase);
+        for (int step = 0; step < headlessSteps; step++)
+        {
+            stepSimulation();
+        }
+        result = bubbles;
+    }
+
+    std::sort(result.begin(), result.end(), [](const Bubble &a, const Bubble &b) {
+        return std::make_tuple(a.position.x, a.position.y, a.direction.x, a.direction.y) <
+               std::make_tuple(b.position.x, b.position.y, b.direction.x, b.direction.y);
+    });
+    return result;
+}
+
+// Function to find the first bubble that differs between the reference and the parallel run
+// Returns -1 if every bubble matches within the tolerance.
+int findMismatch(const std::vector<Bubble> &reference, const std::vector<Bubble> &result)
+{
+    if (reference.size() != result.size())
+    {
+        return std::min(reference.size(), result.size());
+    }
+
+    for (size_t i = 0; i < reference.size(); i++)
+    {
+        const Bubble &a = reference[i], &b = result[i];
+        bool matches = std::abs(a.position.x - b.position.x) <= VERIFY_TOLERANCE &&
+                       std::abs(a.position.y - b.position.y) <= VERIFY_TOLERANCE &&
+                       std::abs(a.direction.x - b.direction.x) <= VERIFY_TOLERANCE &&
+                       std::abs(a.direction.y - b.direction.y) <= VERIFY_TOLERANCE &&
+                       a.collisionCount == b.collisionCount && a.totalCollisions == b.totalCollisions &&
+                       a.isCollisionActive == b.isCollisionActive &&
+                       a.lastCollisionFrame == b.lastCollisionFrame && a.birthFrame == b.birthFrame;
+        if (!matches)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Function to check the parallel engine against the brute-force engine on one thread
+// Every case fuzzes the number of bubbles, the thread count, the loop schedule and the broad phase,
+// runs the simulation once with the brute-force broad phase on one thread with a static schedule
+// (the reference) and once with the fuzzed settings, and compares the final bubbles. A broad phase
+// that misses pairs, or a race, shows up as a mismatch. With --processes the fuzzed run is split
+// into that many workers and the reference runs in a single worker, so the strips, their halo and
+// the migration are checked as well. Returns 1 if any case differs.
+int runVerify(int num_bubbles)
+{
+    WORLD_WIDTH = requestedWorldWidth > 0 ? requestedWorldWidth : HEADLESS_WORLD_WIDTH;
+    WORLD_HEIGHT = requestedWorldHeight > 0 ? requestedWorldHeight : HEADLESS_WORLD_HEIGHT;
+
+    spawn_dis_x = std::uniform_int_distribution<>(100, std::max(WORLD_WIDTH - 200, 100));
+    spawn_dis_y = std::uniform_int_distribution<>(100, std::max(WORLD_HEIGHT - 200, 100));
+
+    // Cases are drawn from the main generator, so --seed reproduces a failing sequence
+    std::mt19937 fuzz(gen());
+    int maxThreads = std::max(2 * omp_get_num_procs(), 8);  // Oversubscribed teams shake the schedules
+    int failures = 0;
+
+    for (int c = 0; c < verifyCases; c++)
+    {
+        VerifyCase test;
+        test.bubbles = std::uniform_int_distribution<>(1, num_bubbles)(fuzz);
+        test.threads = std::uniform_int_distribution<>(2, maxThreads)(fuzz);
+        test.schedule = static_cast<omp_sched_t>(std::uniform_int_distribution<>(1, 4)(fuzz));
+        test.chunk = std::uniform_int_distribution<>(0, 64)(fuzz);
+        test.broadPhase = broadPhaseRequested ? broadPhase
+                                              : static_cast<BroadPhase>(c % BROAD_PHASE_COUNT);
+        test.regions = std::uniform_int_distribution<>(1, 16)(fuzz);
+        test.seed = fuzz();
+        test.processes = numProcesses;
+
+        // Strips replace the vertical regions in distributed mode
+        if (test.processes > 0 && test.broadPhase == BROAD_PHASE_REGIONS)
+        {
+            test.broadPhase = BROAD_PHASE_BRUTE_FORCE;
+        }
+
+        std::vector<Bubble> reference = runVerifyCase(test, BROAD_PHASE_BRUTE_FORCE, 1, omp_sched_static, 0,
+                                                      test.processes > 0 ? 1 : 0);
+        std::vector<Bubble> result = runVerifyCase(test, test.broadPhase, test.threads, test.schedule, test.chunk,
+                                                   test.processes);
+        int mismatch = findMismatch(reference, result);
+
+        std::cout << "Case " << c + 1 << "/" << verifyCases << " | Bubbles: " << test.bubbles
+                  << " | Processes: " << test.processes << " | Threads: " << test.threads
+                  << " | Schedule: " << SCHEDULE_NAMES[test.schedule] << "," << test.chunk
+                  << " | Broad phase: " << BROAD_PHASE_NAMES[test.broadPhase]
+                  << " | Regions: " << test.regions << " | Seed: " << test.seed;
+        if (mismatch < 0)
+        {
+            std::cout << " | OK" << std::endl;
+            continue;
+        }
+
+        failures++;
+        std::cout << " | MISMATCH at bubble " << mismatch << std::endl;
+        if (mismatch < static_cast<int>(std::min(reference.size(), result.size())))
+        {
+            const Bubble &a = reference[mismatch], &b = result[mismatch];
+            printf("    reference: position (%f, %f) direction (%f, %f) collisions %d/%d\n",
+                   a.position.x, a.position.y, a.direction.x, a.direction.y, a.collisionCount, a.totalCollisions);
+            printf("    parallel:  position (%f, %f) direction (%f, %f) collisions %d/%d\n",
+                   b.position.x, b.position.y, b.direction.x, b.direction.y, b.collisionCount, b.totalCollisions);
+        }
+        else
+        {
+            printf("    reference run has %zu bubbles, parallel run has %zu\n", reference.size(), result.size());
+        }
+    }
+
+    std::cout << "Verified " << verifyCases - failures << "/" << verifyCases << " cases over "
+              << headlessSteps << " steps" << std::endl;
+    return failures > 0 ? 1 : 0;
+}
+
+// Function to parse an optional command-line argument
+// Returns false if the argument is not a known option.
+bool parseOption(const char *arg)
+{
+    if (strcmp(arg, "--cull") == 0)
+    {
+        cullingEnabled = true;
+        return true;
+    }
+    if (strncmp(arg, "--zoom=", 7) == 0)
+    {
+        char *endptr;
+        initialZoom = strtof(arg + 7, &endptr);
+        return initialZoom > 0 && *endptr == '\0';
+    }
+    if (strcmp(arg, "--multi-display") == 0)
+    {
+        multiDisplayEnabled = true;
+        return true;
+    }
+    if (strncmp(arg, "--world=", 8) == 0)
+    {
+        char *endptr;
+        requestedWorldWidth = strtol(arg + 8, &endptr, 10);
+        if (*endptr != 'x')
+        {
+            return false;
+        }
+        requestedWorldHeight = strtol(endptr + 1, &endptr, 10);
+        return requestedWorldWidth > 0 && requestedWorldHeight > 0 && *endptr == '\0';
+    }
+    if (strncmp(arg, "--regions=", 10) == 0)
+    {
+        char *endptr;
+        numRegions = strtol(arg + 10, &endptr, 10);
+        broadPhase = BROAD_PHASE_REGIONS;
+        broadPhaseRequested = true;
+        return numRegions > 0 && *endptr == '\0';
+    }
+    if (strncmp(arg, "--broad-phase=", 14) == 0)
+    {
+        for (int phase = 0; phase < BROAD_PHASE_COUNT; phase++)
+        {
+            if (strcmp(arg + 14, BROAD_PHASE_NAMES[phase]) == 0)
+            {
+                broadPhase = static_cast<BroadPhase>(phase);
+                broadPhaseRequested = true;
+                return true;
+            }
+        }
+        return false;
+    }
+    if (strcmp(arg, "--overlay") == 0)
+    {
+        overlayEnabled = true;
+        return true;
+    }
+    if (strcmp(arg, "--wrap") == 0)
+    {
+        wrapWallsEnabled = true;
+        return true;
+    }
+    if (strcmp(arg, "--no-color-animation") == 0)
+    {
+        colorAnimationEnabled = false;
+        return true;
+    }
+    if (strcmp(arg, "--random-color-speed") == 0)
+    {
+        randomColorSpeedEnabled = true;
+        return true;
+    }
+    if (strncmp(arg, "--pop-after=", 12) == 0)
+    {
+        char *endptr;
+        popAfterCollisions = strtol(arg + 12, &endptr, 10);
+        return popAfterCollisions > 0 && *endptr == '\0';
+    }
+    if (strncmp(arg, "--max-age=", 10) == 0)
+    {
+        char *endptr;
+        long age = strtol(arg + 10, &endptr, 10);
+        maxBubbleAge = age;
+        return age > 0 && *endptr == '\0';
+    }
+    if (strcmp(arg, "--respawn") == 0)
+    {
+        respawnEnabled = true;
+        return true;
+    }
+    if (strncmp(arg, "--seed=", 7) == 0)
+    {
+        char *endptr;
+        gen.seed(strtoul(arg + 7, &endptr, 10));
+        return arg[7] != '\0' && *endptr == '\0';
+    }
+    if (strcmp(arg, "--verify") == 0)
+    {
+        verifyCases = 20;
+        headlessEnabled = true;
+        return true;
+    }
+    if (strncmp(arg, "--verify=", 9) == 0)
+    {
+        char *endptr;
+        verifyCases = strtol(arg + 9, &endptr, 10);
+        headlessEnabled = true;
+        return verifyCases > 0 && *endptr == '\0';
+    }
+    if (strcmp(arg, "--adaptive") == 0)
+    {
+        adaptiveEnabled = true;
+        return true;
+    }
+    if (strcmp(arg, "--headless") == 0)
+    {
+        headlessEnabled = true;
+        return true;
+    }
+    if (strncmp(arg, "--steps=", 8) == 0)
+    {
+        char *endptr;
+        headlessSteps = strtol(arg + 8, &endptr, 10);
+        return headlessSteps > 0 && *endptr == '\0';
+    }
+#if defined(__unix__)
+    if (strncmp(arg, "--processes=", 12) == 0)
+    {
+        char *endptr;
+        numProcesses = strtol(arg + 12, &endptr, 10);
+        headlessEnabled = true;
+        return numProcesses > 0 && *endptr == '\0';
+    }
+    if (strncmp(arg, "--publish=", 10) == 0)
+    {
+        publishName = arg + 10;
+        return publishName[0] == '/' && strchr(publishName + 1, '/') == NULL;
+    }
+#endif
+    return false;
+}
+
+// Main function
+int main(int argc, char *argv[]){
+    int num_bubbles;    // Number of bubbles
+
+    std::cout << "Initializing SDL" << std::endl;
+
+    // Ensure the correct number of arguments is provided
+    if (argc < 3)
+    {
+        std::cout << "Usage: " << argv[0] << " <Number of Bubbles> <Target FPS> [--cull] [--zoom=<f>]"
+                  << " [--multi-display] [--world=<W>x<H>] [--regions=<R>]"
+                  << " [--headless] [--steps=<K>] [--processes=<P>] [--publish=<name>]"
+                  << " [--broad-phase=<brute|grid|regions|bvh>] [--overlay]"
+                  << " [--wrap] [--no-color-animation] [--random-color-speed]"
+                  << " [--pop-after=<C>] [--max-age=<F>] [--respawn] [--seed=<S>]"
+                  << " [--adaptive] [--verify[=<C>]]" << std::endl;
+        return 1;
+    }
+
+    // Convert command-line arguments to integers
+    char *endptr1, *endptr2;
+    num_bubbles = strtol(argv[1], &endptr1, 10);    // Number of bubbles to display
+    FPS = strtol(argv[2], &endptr2, 10); // Number of desired FPS
+
+    // Validate the input
+    if (num_bubbles <= 0 || *endptr1 != '\0') {
+        printf("Error: Please enter a positive integer for the number of bubbles.\n");
+        return 1;
+    }
+
+    // Validate the input
+    if (FPS <= 0 || *endptr2 != '\0') {
+        printf("Error: Please enter a positive integer for the number of FPS.\n");
+        return 1;
+    }
+
+    // Parse the optional arguments
+    for (int i = 3; i < argc; i++)
+    {
+        if (!parseOption(argv[i]))
+        {
+            printf("Error: Unknown or invalid option '%s'.\n", argv[i]);
+            return 1;
+        }
+    }
+
+    // Only adaptive runs sleep out the rest of the frame budget; other runs render as fast as they
+    // can, so their frame times measure the whole workload
+    FRAME_DELAY = adaptiveEnabled ? 1000 / FPS : 0;
+
+    // Wrapping would hand bubbles to a non-neighbouring strip of a distributed run
+    if (wrapWallsEnabled && numProcesses > 0)
+    {
+        printf("Error: --wrap cannot be combined with --processes.\n");
+        return 1;
+    }
+
+    // Workers respawn inside their own strip, which a single-process reference cannot reproduce
+    if (verifyCases > 0 && respawnEnabled && numProcesses > 0)
+    {
+        printf("Error: --verify cannot check --respawn with --processes.\n");
+        return 1;
+    }
+
+    // Convert the collision cooldown to simulation steps at the target FPS
+    collisionPeriodFrames = std::max<Uint32>(COLLISION_TIME_PERIOD * FPS / 1000, 1);
+
+    // Pick the kernels specialised for the requested settings
+    selectKernels();
+
+    // Loops with schedule(runtime) are statically scheduled unless OMP_SCHEDULE says otherwise
+    if (!getenv("OMP_SCHEDULE"))
+    {
+        omp_set_schedule(omp_sched_static, 0);
+    }
+
+    // Run without a window: only the header of the bubble image is read, for its size
+    if (headlessEnabled)
+    {
+        resolveSpritePaths();
+        if (!loadSpriteSize())
+        {
+            return 1;
+        }
+
+        int status;
+        if (verifyCases > 0)
+        {
+            status = runVerify(num_bubbles);   // Checks the distributed mode too with --processes
+        }
+#if defined(__unix__)
+        else if (numProcesses > 0)
+        {
+            status = runDistributed(num_bubbles);
+        }
+#endif
+        else
+        {
+            status = runHeadless(num_bubbles);
+        }
+        return status;
+    }
+
+    // Initialize SDL
+    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+    {
+        SDL_Log("Unable to initialize SDL: %s", SDL_GetError());
+        return 1;
+    }
+
+    // Initialize SDL_image
+    if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG))
+    {
+        SDL_Log("Failed to initialize SDL_image: %s", IMG_GetError());
+        SDL_Quit();
+        return 1;
+    }
+
+    // Read the size of the bubble image and decode its sprite in the background
+    resolveSpritePaths();
+    if (!loadSpriteSize())
+    {
+        IMG_Quit();
+        SDL_Quit();
+        return 1;
+    }
+    spriteLoader = std::thread(loadSpriteImage);
+
+    // Initialize screen dimensions
+    initializeScreenDimensions();
+
+    // Initialize world dimensions from the displays and the requested canvas size
+    initializeWorldDimensions(multiDisplayEnabled, requestedWorldWidth, requestedWorldHeight);
+
+    // A world spanning several displays is split into one region per thread by default
+    if (!broadPhaseRequested && (multiDisplayEnabled || requestedWorldWidth > 0))
+    {
+        broadPhase = BROAD_PHASE_REGIONS;
+    }
+
+    spawn_dis_x = std::uniform_int_distribution<>(100, std::max(WORLD_WIDTH - 200, 100));   // Distribution for random spawn value in x
+    spawn_dis_y = std::uniform_int_distribution<>(100, std::max(WORLD_HEIGHT - 200, 100));   // Distribution for random spawn value in y
+
+    // Create a window and a renderer for every display
+    if (!createViews())
+    {
+        destroyViews();
+        SDL_Quit();
+        return 1;
+    }
+
+    // Spawn the bubbles
+    for (int i = 0; i < num_bubbles; i++)
+    {
+        spawnBubble();
+    }
+
+    if (broadPhase == BROAD_PHASE_REGIONS)
+    {
+        setBroadPhase(BROAD_PHASE_REGIONS);
+    }
+
+#if defined(__unix__)
+    // Open the shared-memory ring before the first frame is completed
+    if (publishName && !openPublisher(num_bubbles))
+    {
+        destroyViews();
+        SDL_Quit();
+        return 1;
+    }
+#endif
+
     // Variables for frame rate calculation
     SDL_Event event;
     bool running = true;
     int frameCount = 0;
     Uint32 startTime = SDL_GetTicks();
     Uint32 currentTime = startTime;
+    double ticksPerMs = SDL_GetPerformanceFrequency() / 1000.0;
     float totalFrameTime = 0;
     int framesAccumulated = 0;
     float endAvg;
@@ -450,7 +3237,7 @@ int main(int argc, char *argv[]){
     // Main loop
     while (running)
     {
-        Uint32 frameStart = SDL_GetTicks();
+        Uint64 frameStart = SDL_GetPerformanceCounter();
         
         while (SDL_PollEvent(&event))
         {
@@ -458,24 +3245,53 @@ int main(int argc, char *argv[]){
             {
                 running = false;
             }
+            else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE)
+            {
+                // Borderless windows have no close button
+                running = false;
+            }
+            else if (event.type == SDL_KEYDOWN)
+            {
+                handleKeyDown(event.key.keysym.sym);
+            }
+            else if (event.type == SDL_MOUSEWHEEL && cullingEnabled)
+            {
+                // Zoom the view under the mouse around its center
+                for (auto &view : views)
+                {
+                    if (SDL_GetWindowID(view.window) == event.wheel.windowID)
+                    {
+                        zoomViewport(view, event.wheel.y > 0 ? 1.25f : 0.8f, glm::vec2(view.width / 2, view.height / 2));
+                    }
+                }
+            }
         }
 
         // Render the bubbles
         render();
         frameCount++;
 
-        // Calculate the frame time for this frame
+        // Calculate the frame time for this frame (the performance counter resolves far below 1 ms)
         Uint32 frameEnd = SDL_GetTicks();
-        float frameTime = static_cast<float>(frameEnd - frameStart);
+        double frameTime = (SDL_GetPerformanceCounter() - frameStart) / ticksPerMs;
         totalFrameTime += frameTime; // Accumulate total frame time
         framesAccumulated++; // Count the number of frames accumulated
 
+        // Adjust quality and threads to the frame budget
+        if (adaptiveEnabled)
+        {
+            adaptQuality(frameTime);
+        }
+
         // Update the FPS and average frame time in the window title
         if (frameEnd - currentTime >= 1000)
         {
             float avgFrameTime = totalFrameTime / framesAccumulated;
-            std::string title = "FPS: " + std::to_string(frameCount) + " | Avg Frame Time: " + std::to_string(avgFrameTime) + " ms";
-            SDL_SetWindowTitle(window, title.c_str());
+            std::string title = "FPS: " + std::to_string(frameCount) + " | Avg Frame Time: " + std::to_string(avgFrameTime) + " ms" + describeSettings();
+            for (auto &view : views)
+            {
+                SDL_SetWindowTitle(view.window, title.c_str());
+            }
             endAvg = avgFrameTime;
             frameCount = 0;
             totalFrameTime = 0; // Reset total frame time for the next second
@@ -483,24 +3299,22 @@ int main(int argc, char *argv[]){
             currentTime = frameEnd; // Update the current time
         }
 
-        Uint32 frameDelay = SDL_GetTicks() - frameStart;
-        if (frameDelay < FRAME_DELAY)
+        double elapsed = (SDL_GetPerformanceCounter() - frameStart) / ticksPerMs;
+        if (elapsed < FRAME_DELAY)
         {
-            SDL_Delay(FRAME_DELAY - frameDelay);
+            SDL_Delay(static_cast<Uint32>(FRAME_DELAY - elapsed));
         }
     }
 
     // Clean up resources
-    for (auto &bubble : bubbles)
-    {
-        SDL_DestroyTexture(bubble.texture);
-    }
-
-    SDL_DestroyRenderer(renderer);
-    SDL_DestroyWindow(window);
+    destroyViews();
     IMG_Quit();
     SDL_Quit();
 
+#if defined(__unix__)
+    closeBubbleShm(publisher);
+#endif
+
     std::cout << "End Average Frame Time: " << std::to_string(static_cast<float>(endAvg));
 
     return 0;
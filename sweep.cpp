@@ -0,0 +1,455 @@
+/**
+ * Bubble Screensaver Sweep Driver
+ *
+ * @brief
+ * This program runs the parallel screensaver headless over a grid of (number of bubbles, FPS, thread
+ * count) values and aggregates the timings of every run into a single CSV file. Independent runs are
+ * executed concurrently: the cores the driver may run on are partitioned between them, every run is
+ * pinned to its own set of cores and gets an OpenMP team of the requested size, so that runs do not
+ * compete for the same cores. The output of every run is drained while it runs, so a run never
+ * blocks on a full pipe.
+ *
+ * @usage:
+ *  Run the program with the command:
+ *      ./BubbleSweep <config file> [output CSV]
+ *  The config file contains one "key = values" entry per line ('#' starts a comment):
+ *      bubbles = 500 1000 2000     # Numbers of bubbles to test
+ *      fps = 30 60                 # Target FPS of every run
+ *      threads = 1 2 4             # OpenMP thread counts to test
+ *      steps = 500                 # Steps performed by every run (optional, default 500)
+ *      cores = 8                   # Cores shared by the concurrent runs (optional, default: all allowed)
+ *      binary = ./BubbleScreensaverParallel    # Simulation binary (optional)
+ *
+ * @libraries:
+ *  - POSIX (fork, exec, poll and CPU affinity)
+**/
+
+// Standard C++ libraries for various functionalities
+#include <vector>           // STL vector container
+#include <iostream>         // For input and output operations
+#include <fstream>          // For reading the config file and writing the CSV
+#include <sstream>          // For parsing config lines
+#include <string>           // For string handling
+#include <map>              // For mapping running processes to their jobs
+#include <algorithm>        // For std::count and std::stable_sort
+#include <cerrno>           // For errno
+#include <cstdlib>          // For strtol and exit
+#include <cstring>          // For strerror
+
+// POSIX headers for launching and pinning the runs
+#include <fcntl.h>          // For O_CLOEXEC
+#include <poll.h>           // For waiting on the output of the runs
+#include <sched.h>          // For sched_getaffinity and sched_setaffinity
+#include <signal.h>         // For kill
+#include <sys/wait.h>       // For waitpid
+#include <unistd.h>         // For fork, exec and pipe2
+#include <time.h>           // For clock_gettime
+
+// Structure representing one point of the sweep
+struct Job
+{
+    int bubbles;              // Number of bubbles
+    int fps;                  // Target FPS
+    int threads;              // Number of OpenMP threads
+    std::vector<int> cores;   // Cores the run is pinned to
+    int outputFd;             // Read end of the pipe connected to the run's standard output
+    std::string output;       // Output of the run
+    double startTime;         // Wall-clock time the run was started at
+    double wallTime;          // Wall-clock duration of the run, in seconds
+    int status;               // Exit status of the run
+};
+
+// Structure representing the sweep configuration
+struct SweepConfig
+{
+    std::vector<int> bubbles;                           // Numbers of bubbles to test
+    std::vector<int> fps;                               // Target FPS values to test
+    std::vector<int> threads;                           // Thread counts to test
+    int steps = 500;                                    // Steps performed by every run
+    int cores = 0;                                      // Cores shared by the runs (0 = all allowed)
+    std::string binary = "./BubbleScreensaverParallel"; // Simulation binary
+};
+
+// Function to get the current wall-clock time in seconds
+double now()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Function to parse a list of positive integers
+bool parseIntegers(std::istringstream &values, std::vector<int> &out)
+{
+    std::string value;
+    while (values >> value)
+    {
+        char *endptr;
+        long number = strtol(value.c_str(), &endptr, 10);
+        if (number <= 0 || *endptr != '\0')
+        {
+            return false;
+        }
+        out.push_back(number);
+    }
+    return !out.empty();
+}
+
+// Function to read the sweep configuration
+// Returns false (after printing the offending line) if the file is missing or malformed.
+bool loadConfig(const char *path, SweepConfig &config)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        std::cout << "Error: Unable to open config file '" << path << "'." << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+
+        size_t equals = line.find('=');
+        std::istringstream keyStream(line.substr(0, equals));
+        std::string key;
+        if (!(keyStream >> key))
+        {
+            continue;   // Empty or comment-only line
+        }
+
+        std::istringstream values(equals == std::string::npos ? "" : line.substr(equals + 1));
+        std::vector<int> numbers;
+        bool valid;
+        if (key == "bubbles")
+        {
+            valid = parseIntegers(values, config.bubbles);
+        }
+        else if (key == "fps")
+        {
+            valid = parseIntegers(values, config.fps);
+        }
+        else if (key == "threads")
+        {
+            valid = parseIntegers(values, config.threads);
+        }
+        else if (key == "steps" || key == "cores")
+        {
+            valid = parseIntegers(values, numbers) && numbers.size() == 1;
+            (key == "steps" ? config.steps : config.cores) = valid ? numbers[0] : 0;
+        }
+        else if (key == "binary")
+        {
+            valid = static_cast<bool>(values >> config.binary);
+        }
+        else
+        {
+            valid = false;
+        }
+
+        if (equals == std::string::npos || !valid)
+        {
+            std::cout << "Error: Invalid config entry at line " << lineNumber << ": " << line << std::endl;
+            return false;
+        }
+    }
+
+    if (config.bubbles.empty() || config.fps.empty() || config.threads.empty())
+    {
+        std::cout << "Error: The config file must define 'bubbles', 'fps' and 'threads'." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Function to list the cores the driver is allowed to run on
+// Only the first `limit` of them are used when `limit` is positive.
+std::vector<int> getAllowedCores(int limit)
+{
+    std::vector<int> cores;
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+        for (int core = 0; core < CPU_SETSIZE; core++)
+        {
+            if (CPU_ISSET(core, &set) && (limit <= 0 || static_cast<int>(cores.size()) < limit))
+            {
+                cores.push_back(core);
+            }
+        }
+    }
+    return cores;
+}
+
+// Function to launch one headless run pinned to its cores
+// The run's standard output is redirected to a pipe read by the driver. Both ends are close-on-exec,
+// so later runs do not inherit the pipes of earlier ones.
+pid_t launchJob(Job &job, const SweepConfig &config)
+{
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) != 0)
+    {
+        perror("pipe2");
+        return -1;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        perror("fork");
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+
+    if (pid == 0)
+    {
+        // Pin the run to its partition of the cores
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int core : job.cores)
+        {
+            CPU_SET(core, &set);
+        }
+        sched_setaffinity(0, sizeof(set), &set);
+
+        // One OpenMP team of the requested size, bound to the partition
+        setenv("OMP_NUM_THREADS", std::to_string(job.threads).c_str(), 1);
+        setenv("OMP_PROC_BIND", "close", 1);
+
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[0]);
+        close(fds[1]);
+
+        std::string bubbles = std::to_string(job.bubbles);
+        std::string fps = std::to_string(job.fps);
+        std::string steps = "--steps=" + std::to_string(config.steps);
+        execl(config.binary.c_str(), config.binary.c_str(), bubbles.c_str(), fps.c_str(),
+              "--headless", steps.c_str(), (char *)NULL);
+
+        std::cerr << "Unable to run '" << config.binary << "': " << strerror(errno) << std::endl;
+        _exit(127);
+    }
+
+    close(fds[1]);
+    job.outputFd = fds[0];
+    job.startTime = now();
+    return pid;
+}
+
+// Function to read the value that follows a label in the output of a run
+// Returns a negative value if the label is missing.
+double findValue(const std::string &output, const std::string &label)
+{
+    size_t position = output.rfind(label);
+    if (position == std::string::npos)
+    {
+        return -1;
+    }
+    return strtod(output.c_str() + position + label.size(), NULL);
+}
+
+// Function to read the output a run has written since the last call
+// Returns false once the run closed its standard output (it exited).
+bool readOutput(Job &job)
+{
+    char buffer[4096];
+    ssize_t count = read(job.outputFd, buffer, sizeof(buffer));
+    if (count < 0 && errno == EINTR)
+    {
+        return true;
+    }
+    if (count <= 0)
+    {
+        close(job.outputFd);
+        return false;
+    }
+    job.output.append(buffer, count);
+    return true;
+}
+
+// Function to stop and reap every run still in progress
+// Used when the sweep is aborted, so no run is left behind.
+void stopJobs(std::map<pid_t, Job> &running)
+{
+    for (auto &entry : running)
+    {
+        kill(entry.first, SIGTERM);
+        close(entry.second.outputFd);
+    }
+    for (auto &entry : running)
+    {
+        waitpid(entry.first, NULL, 0);
+    }
+    running.clear();
+}
+
+// Function to write the results of a run as one CSV row
+void writeRow(std::ofstream &csv, const Job &job, const SweepConfig &config)
+{
+    double avg = findValue(job.output, "Avg Step Time: ");
+    double p95 = findValue(job.output, "P95 Step Time: ");
+    double max = findValue(job.output, "Max Step Time: ");
+    bool ok = job.status == 0 && avg > 0;
+
+    csv << job.bubbles << ',' << job.fps << ',' << job.threads << ',' << config.steps << ',';
+    if (ok)
+    {
+        double budget = 1000.0 / job.fps;
+        csv << avg << ',' << p95 << ',' << max << ','
+            << 1000.0 / avg << ',' << (p95 <= budget ? 1 : 0) << ','
+            << job.bubbles * 1000.0 / avg << ',';
+    }
+    else
+    {
+        csv << ",,,,,,";
+    }
+    csv << job.wallTime << ',' << (ok ? "ok" : "failed") << '\n';
+}
+
+// Main function
+int main(int argc, char *argv[])
+{
+    // Ensure the correct number of arguments is provided
+    if (argc < 2 || argc > 3)
+    {
+        std::cout << "Usage: " << argv[0] << " <Config File> [Output CSV]" << std::endl;
+        return 1;
+    }
+
+    SweepConfig config;
+    if (!loadConfig(argv[1], config))
+    {
+        return 1;
+    }
+
+    std::string outputPath = argc == 3 ? argv[2] : "sweep.csv";
+    std::ofstream csv(outputPath);
+    if (!csv)
+    {
+        std::cout << "Error: Unable to write '" << outputPath << "'." << std::endl;
+        return 1;
+    }
+    csv << "bubbles,fps,threads,steps,avg_step_ms,p95_step_ms,max_step_ms,"
+           "achievable_fps,meets_target,bubble_steps_per_sec,wall_s,status\n";
+
+    // Partition the cores the driver itself may run on (they are not always 0..N-1)
+    std::vector<int> allowedCores = getAllowedCores(config.cores);
+    int totalCores = allowedCores.size();
+    if (totalCores == 0)
+    {
+        perror("sched_getaffinity");
+        return 1;
+    }
+
+    // Build the grid, largest runs first so that small runs fill the gaps at the end
+    std::vector<Job> pending;
+    for (int bubbles : config.bubbles)
+        for (int fps : config.fps)
+            for (int threads : config.threads)
+            {
+                Job job = {};
+                job.bubbles = bubbles;
+                job.fps = fps;
+                job.threads = threads;
+                pending.push_back(job);
+            }
+    std::stable_sort(pending.begin(), pending.end(),
+                     [](const Job &a, const Job &b) { return a.threads > b.threads; });
+
+    // Cores outside the allowed set are marked busy forever
+    std::vector<char> coreBusy(CPU_SETSIZE, 1);
+    for (int core : allowedCores)
+    {
+        coreBusy[core] = 0;
+    }
+    std::map<pid_t, Job> running;
+    size_t finished = 0, total = pending.size();
+    double sweepStart = now();
+
+    while (!pending.empty() || !running.empty())
+    {
+        // Start every pending run that fits in the free cores
+        for (size_t i = 0; i < pending.size();)
+        {
+            Job &job = pending[i];
+            int needed = std::min(job.threads, totalCores);
+            int freeCores = std::count(coreBusy.begin(), coreBusy.end(), 0);
+            if (needed > freeCores)
+            {
+                i++;
+                continue;
+            }
+
+            for (size_t k = 0; k < allowedCores.size() && static_cast<int>(job.cores.size()) < needed; k++)
+            {
+                int core = allowedCores[k];
+                if (!coreBusy[core])
+                {
+                    coreBusy[core] = 1;
+                    job.cores.push_back(core);
+                }
+            }
+
+            pid_t pid = launchJob(job, config);
+            if (pid < 0)
+            {
+                stopJobs(running);
+                return 1;
+            }
+            running[pid] = job;
+            pending.erase(pending.begin() + i);
+        }
+
+        // Wait for output from any run; a run is finished once its output reaches end of file
+        std::vector<pollfd> fds;
+        std::vector<pid_t> pids;
+        for (auto &entry : running)
+        {
+            fds.push_back({entry.second.outputFd, POLLIN, 0});
+            pids.push_back(entry.first);
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            perror("poll");
+            stopJobs(running);
+            return 1;
+        }
+
+        for (size_t k = 0; k < fds.size(); k++)
+        {
+            Job &job = running[pids[k]];
+            if (fds[k].revents == 0 || readOutput(job))
+            {
+                continue;
+            }
+
+            // Reap the run and release its cores
+            int status = 0;
+            bool reaped = waitpid(pids[k], &status, 0) == pids[k];
+            job.wallTime = now() - job.startTime;
+            job.status = reaped && WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+            for (int core : job.cores)
+            {
+                coreBusy[core] = 0;
+            }
+
+            writeRow(csv, job, config);
+            finished++;
+            std::cout << "[" << finished << "/" << total << "] N=" << job.bubbles << " FPS=" << job.fps
+                      << " threads=" << job.threads << (job.status == 0 ? "" : " (failed)") << std::endl;
+            running.erase(pids[k]);
+        }
+    }
+
+    std::cout << "Sweep finished in " << std::to_string(now() - sweepStart) << " s, results written to "
+              << outputPath << std::endl;
+    return 0;
+}
@@ -0,0 +1,276 @@
+/**
+ * Bubble Shared-Memory Publication
+ *
+ * @brief
+ * Layout and helpers for publishing the bubbles of every completed frame into a POSIX shared-memory
+ * ring, so that other processes on the same host (overlays, metrics agents, ...) can read consistent
+ * snapshots without copying them through a socket and without locking the simulation.
+ *
+ * The segment starts with a BubbleShmHeader followed by BUBBLE_SHM_SLOTS slots. Frame f is written
+ * into slot f % BUBBLE_SHM_SLOTS. Every slot is protected by a seqlock: its sequence number is odd
+ * while the writer fills the slot and even once the slot is consistent. A reader copies the slot
+ * of the latest frame and retries if the sequence changed while it was copying.
+ *
+ * The capacity of a segment is fixed. When the simulation outgrows it, the writer creates a larger
+ * segment under the same name and marks the old one as replaced; readers of the old segment must
+ * detach and attach again.
+ *
+ * @usage (reader):
+ *      size_t size;
+ *      const BubbleShmHeader *shm = attachBubbleShm("/bubbles", size);
+ *      std::vector<BubbleSnapshot> bubbles;
+ *      uint64_t frame;
+ *      if (readBubbleShmFrame(shm, bubbles, frame)) { ... }
+ *      else if (isBubbleShmReplaced(shm)) { detachBubbleShm(shm, size); shm = attachBubbleShm("/bubbles", size); }
+ *      detachBubbleShm(shm, size);
+**/
+
+#ifndef BUBBLE_SHM_H
+#define BUBBLE_SHM_H
+
+#include <algorithm>        // For std::min
+#include <atomic>           // For the sequence counters shared between processes
+#include <cstdint>          // For fixed-size integers
+#include <cstring>          // For memcpy
+#include <new>              // For placement new
+#include <vector>           // STL vector container
+
+#include <fcntl.h>          // For O_* constants
+#include <sys/mman.h>       // For shm_open and mmap
+#include <unistd.h>         // For ftruncate and close
+
+// Identifies a bubble segment and its layout version
+const uint32_t BUBBLE_SHM_MAGIC = 0x42424c53; // "BBLS"
+const uint32_t BUBBLE_SHM_VERSION = 2;
+
+// Number of frames kept in the ring
+const uint32_t BUBBLE_SHM_SLOTS = 4;
+
+// State of one bubble as seen by external readers
+struct BubbleSnapshot
+{
+    float x;                  // Center of the bubble in world coordinates
+    float y;
+    float radius;             // Radius of the bubble's bounding circle
+    uint8_t r, g, b, a;       // Current color of the bubble
+};
+
+// Header at the start of the shared-memory segment
+struct BubbleShmHeader
+{
+    uint32_t magic;                  // BUBBLE_SHM_MAGIC once the segment is initialized
+    uint32_t version;                // BUBBLE_SHM_VERSION
+    uint32_t capacity;               // Maximum number of bubbles stored per slot
+    uint32_t slotSize;               // Size in bytes of one slot, including its bubbles
+    float worldWidth;                // Size of the simulated world
+    float worldHeight;
+    std::atomic<uint64_t> latest;    // Latest fully published frame (0 = none yet)
+    std::atomic<uint32_t> replaced;  // Set once a larger segment took over the name
+};
+
+// Header of one slot of the ring, followed by `capacity` BubbleSnapshot entries
+struct alignas(64) BubbleShmSlot
+{
+    std::atomic<uint64_t> sequence;  // Seqlock counter: odd while the slot is being written
+    uint64_t frame;                  // Frame stored in this slot
+    uint32_t count;                  // Number of valid bubbles in this slot
+    uint32_t total;                  // Number of bubbles in the simulation (may exceed capacity)
+};
+
+// Writer side of a bubble segment
+struct BubbleShm
+{
+    char name[64];                   // Name of the POSIX shared-memory object
+    size_t size;                     // Size of the mapping
+    BubbleShmHeader *header;         // Start of the mapping
+};
+
+// Function to get the size of a segment able to hold `capacity` bubbles per frame
+inline size_t getBubbleShmSlotSize(uint32_t capacity)
+{
+    size_t size = sizeof(BubbleShmSlot) + capacity * sizeof(BubbleSnapshot);
+    return (size + 63) / 64 * 64;
+}
+
+// Function to get a slot of a segment
+inline BubbleShmSlot *getBubbleShmSlot(const BubbleShmHeader *header, uint64_t frame)
+{
+    size_t offset = (sizeof(BubbleShmHeader) + 63) / 64 * 64 + (frame % BUBBLE_SHM_SLOTS) * header->slotSize;
+    return reinterpret_cast<BubbleShmSlot *>(reinterpret_cast<char *>(const_cast<BubbleShmHeader *>(header)) + offset);
+}
+
+// Function to get the bubbles stored in a slot
+inline BubbleSnapshot *getBubbleShmData(BubbleShmSlot *slot)
+{
+    return reinterpret_cast<BubbleSnapshot *>(slot + 1);
+}
+
+// Function to create (or replace) the shared-memory segment used to publish the bubbles
+// Returns false if the segment could not be created.
+inline bool openBubbleShm(BubbleShm &shm, const char *name, uint32_t capacity, float worldWidth, float worldHeight)
+{
+    uint32_t slotSize = getBubbleShmSlotSize(capacity);
+    shm.size = (sizeof(BubbleShmHeader) + 63) / 64 * 64 + BUBBLE_SHM_SLOTS * slotSize;
+    strncpy(shm.name, name, sizeof(shm.name) - 1);
+    shm.name[sizeof(shm.name) - 1] = '\0';
+
+    int fd = shm_open(shm.name, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+    if (ftruncate(fd, shm.size) != 0)
+    {
+        close(fd);
+        shm_unlink(shm.name);
+        return false;
+    }
+
+    void *memory = mmap(NULL, shm.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED)
+    {
+        shm_unlink(shm.name);
+        return false;
+    }
+
+    // The mapping is zero-filled, so every slot starts with an even (consistent, empty) sequence
+    shm.header = new (memory) BubbleShmHeader;
+    shm.header->version = BUBBLE_SHM_VERSION;
+    shm.header->capacity = capacity;
+    shm.header->slotSize = slotSize;
+    shm.header->worldWidth = worldWidth;
+    shm.header->worldHeight = worldHeight;
+    shm.header->latest.store(0, std::memory_order_relaxed);
+    shm.header->replaced.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    shm.header->magic = BUBBLE_SHM_MAGIC;
+    return true;
+}
+
+// Function to replace the segment with one able to hold `capacity` bubbles per frame
+// The name is unlinked first, so the old object (still mapped by its readers) keeps its size and
+// layout; it is then flagged as replaced. Returns false, leaving the writer without a segment
+// (shm.header == NULL), if the larger segment cannot be created.
+inline bool growBubbleShm(BubbleShm &shm, uint32_t capacity)
+{
+    BubbleShm grown = {};
+    shm_unlink(shm.name);
+    bool created = openBubbleShm(grown, shm.name, capacity, shm.header->worldWidth, shm.header->worldHeight);
+
+    shm.header->replaced.store(1, std::memory_order_release);
+    munmap(shm.header, shm.size);
+    shm.header = NULL;
+    if (created)
+    {
+        shm = grown;
+    }
+    return created;
+}
+
+// Function to start writing a frame
+// Returns the slot to fill; the caller writes up to `capacity` bubbles into getBubbleShmData(slot).
+inline BubbleShmSlot *beginBubbleShmFrame(BubbleShm &shm, uint64_t frame)
+{
+    BubbleShmSlot *slot = getBubbleShmSlot(shm.header, frame);
+    slot->sequence.fetch_add(1, std::memory_order_relaxed);   // Now odd: readers will retry
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->frame = frame;
+    return slot;
+}
+
+// Function to finish writing a frame and make it the latest one
+inline void endBubbleShmFrame(BubbleShm &shm, BubbleShmSlot *slot, uint32_t count, uint32_t total)
+{
+    slot->count = count;
+    slot->total = total;
+    slot->sequence.fetch_add(1, std::memory_order_release);   // Even again: slot is consistent
+    shm.header->latest.store(slot->frame, std::memory_order_release);
+}
+
+// Function to remove the shared-memory segment
+inline void closeBubbleShm(BubbleShm &shm)
+{
+    if (shm.header)
+    {
+        munmap(shm.header, shm.size);
+        shm_unlink(shm.name);
+        shm.header = NULL;
+    }
+}
+
+// Function to check if the writer moved to a larger segment (readers must attach again)
+inline bool isBubbleShmReplaced(const BubbleShmHeader *header)
+{
+    return header->replaced.load(std::memory_order_acquire) != 0;
+}
+
+// Function to map an existing segment read-only
+// Returns NULL if the segment does not exist or is not a bubble segment.
+inline const BubbleShmHeader *attachBubbleShm(const char *name, size_t &size)
+{
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+
+    size = lseek(fd, 0, SEEK_END);
+    void *memory = size >= sizeof(BubbleShmHeader) ? mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (memory == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    const BubbleShmHeader *header = static_cast<const BubbleShmHeader *>(memory);
+    if (header->magic != BUBBLE_SHM_MAGIC || header->version != BUBBLE_SHM_VERSION)
+    {
+        munmap(memory, size);
+        return NULL;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return header;
+}
+
+// Function to unmap a segment mapped by attachBubbleShm()
+inline void detachBubbleShm(const BubbleShmHeader *header, size_t size)
+{
+    munmap(const_cast<BubbleShmHeader *>(header), size);
+}
+
+// Function to copy the latest published frame
+// Returns false if no frame has been published yet, the segment was replaced or no consistent
+// copy could be made.
+inline bool readBubbleShmFrame(const BubbleShmHeader *header, std::vector<BubbleSnapshot> &bubbles, uint64_t &frame)
+{
+    for (int attempt = 0; attempt < 16 && !isBubbleShmReplaced(header); attempt++)
+    {
+        uint64_t latest = header->latest.load(std::memory_order_acquire);
+        if (latest == 0)
+        {
+            return false;
+        }
+
+        BubbleShmSlot *slot = getBubbleShmSlot(header, latest);
+        uint64_t before = slot->sequence.load(std::memory_order_acquire);
+        if (before & 1)
+        {
+            continue;   // The writer is filling this slot
+        }
+
+        frame = slot->frame;
+        uint32_t count = std::min(slot->count, header->capacity);
+        bubbles.resize(count);
+        memcpy(bubbles.data(), getBubbleShmData(slot), count * sizeof(BubbleSnapshot));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->sequence.load(std::memory_order_relaxed) == before && frame == latest)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif // BUBBLE_SHM_H
@@ -0,0 +1,290 @@
+/**
+ * Bubble Sprite Cache
+ *
+ * @brief
+ * Decodes the bubble image once into premultiplied-alpha RGBA pixels with a chain of mip levels and
+ * stores the result in a raw cache file, so that later starts skip the PNG decode. The cache is a
+ * SpriteCacheHeader followed by the pixels of every level, back to back and tightly packed, so it
+ * can also be mapped directly. It is rebuilt whenever the source image changes (its size or hash).
+ *
+ * @usage:
+ *      std::vector<Uint8> source;
+ *      SpriteImage image;
+ *      if (readSpriteFile(path, source) && !loadSpriteCache(cachePath, source, image))
+ *      {
+ *          decodeSprite(path, image) && writeSpriteCache(cachePath, source, image);
+ *      }
+**/
+
+#ifndef SPRITE_CACHE_H
+#define SPRITE_CACHE_H
+
+#include <SDL2/SDL.h>       // SDL types and surface conversion
+#include <SDL_image.h>      // SDL_image extension for decoding the PNG
+
+#include <algorithm>        // For std::equal and std::min
+#include <cstdio>           // For std::rename and std::remove
+#include <fstream>          // For reading and writing the cache
+#include <string>           // For string handling
+#include <vector>           // STL vector container
+
+// Identifies a sprite cache and its layout version
+const Uint32 SPRITE_CACHE_MAGIC = 0x52505342; // "BSPR"
+const Uint32 SPRITE_CACHE_VERSION = 1;
+
+// Mip chain limits
+const int SPRITE_MAX_LEVELS = 8;       // Largest number of levels, including the full-size one
+const int SPRITE_MIN_LEVEL_SIZE = 4;   // Levels stop before either side gets smaller than this
+
+// Header at the start of the cache file
+struct SpriteCacheHeader
+{
+    Uint32 magic;                        // SPRITE_CACHE_MAGIC
+    Uint32 version;                      // SPRITE_CACHE_VERSION
+    Uint64 sourceSize;                   // Size in bytes of the PNG the cache was built from
+    Uint64 sourceHash;                   // FNV-1a hash of that PNG
+    Uint32 levels;                       // Number of mip levels
+    Uint32 width[SPRITE_MAX_LEVELS];     // Size of every level
+    Uint32 height[SPRITE_MAX_LEVELS];
+};
+
+// Decoded sprite: premultiplied RGBA32 pixels of every level, back to back
+struct SpriteImage
+{
+    int levels;                          // Number of mip levels
+    int width[SPRITE_MAX_LEVELS];        // Size of every level
+    int height[SPRITE_MAX_LEVELS];
+    size_t offset[SPRITE_MAX_LEVELS];    // Offset in bytes of every level in `pixels`
+    std::vector<Uint8> pixels;           // Pixels of all levels (4 bytes per pixel)
+};
+
+// Function to read a whole file
+// Returns false if the file cannot be read.
+inline bool readSpriteFile(const std::string &path, std::vector<Uint8> &data)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        return false;
+    }
+    data.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    return static_cast<bool>(file.read(reinterpret_cast<char *>(data.data()), data.size()));
+}
+
+// Function to hash the source image (64-bit FNV-1a)
+inline Uint64 hashSpriteSource(const std::vector<Uint8> &source)
+{
+    Uint64 hash = 0xcbf29ce484222325ull;
+    for (Uint8 byte : source)
+    {
+        hash = (hash ^ byte) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// Function to read the size of a PNG image from its header, without decoding it
+// Returns false if the data is not a PNG image.
+inline bool readPngSize(const std::vector<Uint8> &source, int &width, int &height)
+{
+    static const Uint8 signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    if (source.size() < 24 || !std::equal(signature, signature + 8, source.begin()) ||
+        std::string(source.begin() + 12, source.begin() + 16) != "IHDR")
+    {
+        return false;
+    }
+
+    // The IHDR chunk stores the size as two big-endian 32-bit integers
+    width = (source[16] << 24) | (source[17] << 16) | (source[18] << 8) | source[19];
+    height = (source[20] << 24) | (source[21] << 16) | (source[22] << 8) | source[23];
+    return width > 0 && height > 0;
+}
+
+// Function to compute the size and offset of every level of an image
+inline void layoutSpriteLevels(SpriteImage &image, int width, int height)
+{
+    size_t offset = 0;
+    image.levels = 0;
+    while (image.levels < SPRITE_MAX_LEVELS &&
+           (image.levels == 0 || (width >= SPRITE_MIN_LEVEL_SIZE && height >= SPRITE_MIN_LEVEL_SIZE)))
+    {
+        image.width[image.levels] = width;
+        image.height[image.levels] = height;
+        image.offset[image.levels] = offset;
+        offset += static_cast<size_t>(width) * height * 4;
+        image.levels++;
+        width /= 2;
+        height /= 2;
+    }
+    image.pixels.resize(offset);
+}
+
+// Function to decode the PNG into premultiplied pixels and build its mip levels
+// Every level is a 2x2 box filter of the previous one, which is exact on premultiplied colors.
+// Returns false if the image cannot be decoded.
+inline bool decodeSprite(const std::string &path, SpriteImage &image)
+{
+    SDL_Surface *loaded = IMG_Load(path.c_str());
+    if (!loaded)
+    {
+        return false;
+    }
+    SDL_Surface *surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+    if (!surface)
+    {
+        return false;
+    }
+
+    layoutSpriteLevels(image, surface->w, surface->h);
+
+    // Level 0: premultiply every color channel by the pixel's alpha
+    SDL_LockSurface(surface);
+    for (int y = 0; y < surface->h; y++)
+    {
+        const Uint8 *row = static_cast<const Uint8 *>(surface->pixels) + y * surface->pitch;
+        Uint8 *out = image.pixels.data() + static_cast<size_t>(y) * surface->w * 4;
+        for (int x = 0; x < surface->w; x++)
+        {
+            Uint8 alpha = row[4 * x + 3];
+            out[4 * x + 0] = (row[4 * x + 0] * alpha + 127) / 255;
+            out[4 * x + 1] = (row[4 * x + 1] * alpha + 127) / 255;
+            out[4 * x + 2] = (row[4 * x + 2] * alpha + 127) / 255;
+            out[4 * x + 3] = alpha;
+        }
+    }
+    SDL_UnlockSurface(surface);
+    SDL_FreeSurface(surface);
+
+    // Next levels: average every 2x2 block of the previous level
+    for (int level = 1; level < image.levels; level++)
+    {
+        const Uint8 *in = image.pixels.data() + image.offset[level - 1];
+        Uint8 *out = image.pixels.data() + image.offset[level];
+        int inWidth = image.width[level - 1];
+        for (int y = 0; y < image.height[level]; y++)
+        {
+            for (int x = 0; x < image.width[level]; x++)
+            {
+                const Uint8 *topLeft = in + (static_cast<size_t>(2 * y) * inWidth + 2 * x) * 4;
+                const Uint8 *bottomLeft = topLeft + inWidth * 4;
+                for (int c = 0; c < 4; c++)
+                {
+                    out[(static_cast<size_t>(y) * image.width[level] + x) * 4 + c] =
+                        (topLeft[c] + topLeft[4 + c] + bottomLeft[c] + bottomLeft[4 + c] + 2) / 4;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Function to convert the premultiplied pixels of every level back to straight alpha
+// Used for renderers that only offer plain alpha blending, which scales the color by alpha itself.
+inline std::vector<Uint8> unpremultiplySprite(const SpriteImage &image)
+{
+    std::vector<Uint8> straight(image.pixels.size());
+    for (size_t i = 0; i < image.pixels.size(); i += 4)
+    {
+        Uint8 alpha = image.pixels[i + 3];
+        for (int c = 0; c < 3; c++)
+        {
+            straight[i + c] = alpha ? std::min((image.pixels[i + c] * 255 + alpha / 2) / alpha, 255) : 0;
+        }
+        straight[i + 3] = alpha;
+    }
+    return straight;
+}
+
+// Function to find the largest fully opaque square centered on the sprite
+// Only these pixels hide what is drawn behind the sprite. The square is grown from the center one
+// ring at a time while every pixel of the ring has full alpha; `footprint` is left empty (w = 0)
+// when the center itself is translucent, as it is for a ring-shaped bubble.
+inline void findOpaqueFootprint(const SpriteImage &image, SDL_Rect &footprint)
+{
+    footprint = {0, 0, 0, 0};
+    if (image.levels == 0)
+    {
+        return;
+    }
+
+    int width = image.width[0], height = image.height[0];
+    int centerX = width / 2, centerY = height / 2;
+    auto isOpaque = [&](int x, int y) { return image.pixels[(static_cast<size_t>(y) * width + x) * 4 + 3] == 255; };
+
+    for (int half = 0; centerX - half >= 0 && centerY - half >= 0 && centerX + half < width && centerY + half < height; half++)
+    {
+        for (int k = -half; k <= half; k++)
+        {
+            if (!isOpaque(centerX + k, centerY - half) || !isOpaque(centerX + k, centerY + half) ||
+                !isOpaque(centerX - half, centerY + k) || !isOpaque(centerX + half, centerY + k))
+            {
+                return;
+            }
+        }
+        footprint = {centerX - half, centerY - half, 2 * half + 1, 2 * half + 1};
+    }
+}
+
+// Function to load the cache if it was built from the given source image
+// Returns false if the cache is missing, stale or damaged.
+inline bool loadSpriteCache(const std::string &cachePath, const std::vector<Uint8> &source, SpriteImage &image)
+{
+    std::ifstream file(cachePath, std::ios::binary);
+    SpriteCacheHeader header;
+    if (!file || !file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+    {
+        return false;
+    }
+    if (header.magic != SPRITE_CACHE_MAGIC || header.version != SPRITE_CACHE_VERSION ||
+        header.sourceSize != source.size() || header.sourceHash != hashSpriteSource(source) ||
+        header.levels == 0 || header.levels > SPRITE_MAX_LEVELS)
+    {
+        return false;
+    }
+
+    layoutSpriteLevels(image, header.width[0], header.height[0]);
+    if (image.levels != static_cast<int>(header.levels))
+    {
+        return false;
+    }
+    return static_cast<bool>(file.read(reinterpret_cast<char *>(image.pixels.data()), image.pixels.size()));
+}
+
+// Function to write the cache for the given source image
+// The file is written under a temporary name and renamed, so concurrent starts never read a partial cache.
+// Returns false if the cache cannot be written (the caller can still use the decoded image).
+inline bool writeSpriteCache(const std::string &cachePath, const std::vector<Uint8> &source, const SpriteImage &image)
+{
+    SpriteCacheHeader header = {};
+    header.magic = SPRITE_CACHE_MAGIC;
+    header.version = SPRITE_CACHE_VERSION;
+    header.sourceSize = source.size();
+    header.sourceHash = hashSpriteSource(source);
+    header.levels = image.levels;
+    for (int level = 0; level < image.levels; level++)
+    {
+        header.width[level] = image.width[level];
+        header.height[level] = image.height[level];
+    }
+
+    std::string temporaryPath = cachePath + ".tmp" + std::to_string(SDL_GetPerformanceCounter());
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file ||
+            !file.write(reinterpret_cast<const char *>(&header), sizeof(header)) ||
+            !file.write(reinterpret_cast<const char *>(image.pixels.data()), image.pixels.size()))
+        {
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temporaryPath.c_str(), cachePath.c_str()) != 0)
+    {
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+#endif // SPRITE_CACHE_H